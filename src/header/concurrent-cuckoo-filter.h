@@ -0,0 +1,338 @@
+#pragma once
+
+#include <vector>     // For std::vector (buckets and lock stripes)
+#include <functional> // For std::hash
+#include <atomic>     // For std::atomic (bucket words, version counters and the count)
+#include <mutex>      // For std::mutex (lock stripes)
+#include <thread>     // For std::this_thread::yield (readers waiting out a move)
+#include <random>     // For std::minstd_rand (choosing which fingerprint to evict, per thread)
+#include <cstdint>    // For std::uint64_t
+#include <cmath>      // For std::log2 and std::ceil (fingerprint size from the false-positive rate)
+
+// This class implements a thread-safe cuckoo filter for read-mostly workloads: many threads call contains while a
+// few threads add and remove. The filter itself works as CuckooFilter (see cuckoo-filter.h): fingerprints of 8 to
+// 16 bits in four-way buckets, with the alternate bucket derived from the bucket and the fingerprint alone.
+//
+// Writers use striped locking, as CuckooConcurrentSet does: bucket i is guarded by stripe i % LOCK_STRIPES, and an
+// operation locks the stripes of both candidate buckets (lower stripe first). Each bucket is one atomic 64-bit word
+// holding its four fingerprints, so readers never see a half-written bucket, at the cost of 16 bits per slot
+// whatever the fingerprint size (about 17 bits per key at 95% load).
+//
+// Readers take no lock. Adding or removing a fingerprint changes a single word, which a reader sees either before
+// or after. Displacement is what could hide a key: a fingerprint moving from the bucket a reader has not read yet
+// to the one it already read is missed. So a writer first searches the whole displacement path without changing
+// anything, then performs it backwards, each step copying a fingerprint into a free slot before clearing its old
+// slot, inside a version bump (a seqlock) of both stripes. A reader that finds nothing checks that the versions of
+// its two stripes did not change and retries if they did; a reader that finds the fingerprint is done at once.
+template <typename T, typename Hash = std::hash<T>>
+class ConcurrentCuckooFilter
+{
+private:
+    using Word = std::uint64_t;
+
+    static constexpr int SLOTS_PER_BUCKET = 4;      // Fingerprints per bucket
+    static constexpr int MIN_FINGERPRINT_BITS = 8;  // Smallest fingerprint size
+    static constexpr int MAX_FINGERPRINT_BITS = 16; // Largest fingerprint size (four of them fill a word)
+    static constexpr double MAX_LOAD = 0.95;        // Load the filter is sized for
+    static constexpr int MAX_DISPLACEMENTS = 500;   // Length of the longest displacement path searched
+    static constexpr int MAX_ATTEMPTS = 8;          // Path searches before an add gives up
+    static constexpr size_t LOCK_STRIPES = 1024;    // Number of lock stripes (and version counters)
+
+    // One lock stripe with its version counter, on its own cache line so readers polling versions do not
+    // share lines with writers taking neighbouring locks. The version is odd while a move is in progress.
+    struct alignas(64) Stripe
+    {
+        std::mutex lock;
+        std::atomic<Word> version{0};
+    };
+
+    // One step of a displacement path: move the fingerprint in slot of bucket to its other bucket
+    struct Step
+    {
+        size_t bucket;
+        int slot;
+        Word tag;
+    };
+
+    int fingerprintBits;                  // Bits per fingerprint (8 .. 16)
+    Word fingerprintMask;                 // Selects one fingerprint
+    size_t buckets;                       // Number of buckets
+    std::vector<std::atomic<Word>> table; // The buckets, one atomic word each
+    std::vector<Stripe> stripes;          // Locks and version counters
+    std::atomic<int> count{0};            // Number of fingerprints stored
+
+    // Hash a key once per operation (splitmix64 finalizer over its Hash value)
+    static Word hashKey(const T &key)
+    {
+        Word x = Hash{}(key);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Fingerprint from the high bits of a key's hash (never 0, which means an empty slot)
+    Word fingerprint(Word keyHash) const
+    {
+        Word tag = (keyHash >> (64 - fingerprintBits)) & fingerprintMask;
+        return tag ? tag : 1;
+    }
+
+    size_t bucketOf(Word keyHash) const
+    {
+        return static_cast<size_t>(keyHash % buckets);
+    }
+
+    // The other bucket of a fingerprint that sits in bucket i (its own inverse, as in CuckooFilter)
+    size_t altBucket(size_t i, Word tag) const
+    {
+        size_t t = static_cast<size_t>((tag * 0x5bd1e995ULL) % buckets);
+        return t >= i ? t - i : t + buckets - i;
+    }
+
+    Word slotOf(Word bucket, int slot) const
+    {
+        return (bucket >> (slot * fingerprintBits)) & fingerprintMask;
+    }
+
+    Word withSlot(Word bucket, int slot, Word tag) const
+    {
+        int shift = slot * fingerprintBits;
+        return (bucket & ~(fingerprintMask << shift)) | (tag << shift);
+    }
+
+    // Index of a slot of bucket holding tag (0 for an empty slot), or -1
+    int find(Word bucket, Word tag) const
+    {
+        for (int slot = 0; slot < SLOTS_PER_BUCKET; ++slot)
+            if (slotOf(bucket, slot) == tag)
+                return slot;
+        return -1;
+    }
+
+    Stripe &stripeOf(size_t i)
+    {
+        return stripes[i % LOCK_STRIPES];
+    }
+
+    // Lock the stripes of buckets a and b in a fixed order (a single lock if they share a stripe)
+    void acquire(size_t a, size_t b)
+    {
+        size_t sa = a % LOCK_STRIPES, sb = b % LOCK_STRIPES;
+        if (sa > sb)
+            std::swap(sa, sb);
+        stripes[sa].lock.lock();
+        if (sb != sa)
+            stripes[sb].lock.lock();
+    }
+
+    void release(size_t a, size_t b)
+    {
+        size_t sa = a % LOCK_STRIPES, sb = b % LOCK_STRIPES;
+        stripes[sa].lock.unlock();
+        if (sb != sa)
+            stripes[sb].lock.unlock();
+    }
+
+    // Put tag into an empty slot of bucket i (its stripe must be locked). Returns false if the bucket is full.
+    bool insertInto(size_t i, Word tag)
+    {
+        Word bucket = table[i].load(std::memory_order_relaxed);
+        int slot = find(bucket, 0);
+        if (slot < 0)
+            return false;
+        table[i].store(withSlot(bucket, slot, tag), std::memory_order_release);
+        return true;
+    }
+
+    // Mark the stripes of buckets a and b as changing (odd versions), or as stable again afterwards
+    void beginMove(size_t a, size_t b)
+    {
+        stripeOf(a).version.fetch_add(1, std::memory_order_relaxed);
+        if (a % LOCK_STRIPES != b % LOCK_STRIPES)
+            stripeOf(b).version.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release); // The odd versions become visible before the bucket stores
+    }
+
+    void endMove(size_t a, size_t b)
+    {
+        stripeOf(a).version.fetch_add(1, std::memory_order_release);
+        if (a % LOCK_STRIPES != b % LOCK_STRIPES)
+            stripeOf(b).version.fetch_add(1, std::memory_order_release);
+    }
+
+    // Search a displacement path from bucket start without changing anything: random evictions, until the evicted
+    // fingerprint's other bucket has an empty slot. Returns false if none was found within MAX_DISPLACEMENTS steps.
+    bool findPath(size_t start, std::vector<Step> &path)
+    {
+        thread_local std::minstd_rand rng(std::random_device{}());
+        path.clear();
+        size_t i = start;
+        for (int n = 0; n < MAX_DISPLACEMENTS; ++n)
+        {
+            Word bucket = table[i].load(std::memory_order_acquire);
+            int slot = static_cast<int>(rng() % SLOTS_PER_BUCKET);
+            Word tag = slotOf(bucket, slot);
+            if (tag == 0) // A slot freed up meanwhile: the path can end here
+                return true;
+            path.push_back({i, slot, tag});
+            i = altBucket(i, tag);
+            if (find(table[i].load(std::memory_order_acquire), 0) >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Perform a path backwards, so that every step moves a fingerprint into a slot the previous step left free.
+    // Each step is checked again under the locks of its two buckets; returns false if another writer got in the way.
+    bool movePath(const std::vector<Step> &path)
+    {
+        for (size_t k = path.size(); k-- > 0;)
+        {
+            const Step &step = path[k];
+            size_t to = altBucket(step.bucket, step.tag);
+            acquire(step.bucket, to);
+            Word from = table[step.bucket].load(std::memory_order_relaxed);
+            Word dest = table[to].load(std::memory_order_relaxed);
+            int free = find(dest, 0);
+            if (slotOf(from, step.slot) != step.tag || free < 0)
+            {
+                release(step.bucket, to);
+                return false;
+            }
+            beginMove(step.bucket, to);
+            table[to].store(withSlot(dest, free, step.tag), std::memory_order_relaxed); // Copy first,
+            if (to != step.bucket)
+                table[step.bucket].store(withSlot(from, step.slot, 0), std::memory_order_relaxed); // then clear
+            else
+                table[to].store(withSlot(withSlot(dest, free, step.tag), step.slot, 0), std::memory_order_relaxed);
+            endMove(step.bucket, to);
+            release(step.bucket, to);
+        }
+        return true;
+    }
+
+    // Bits per fingerprint needed for a false-positive rate of at most rate
+    static int bitsFor(double rate)
+    {
+        int bits = static_cast<int>(std::ceil(std::log2(2.0 * SLOTS_PER_BUCKET / rate)));
+        return bits < MIN_FINGERPRINT_BITS ? MIN_FINGERPRINT_BITS : bits > MAX_FINGERPRINT_BITS ? MAX_FINGERPRINT_BITS : bits;
+    }
+
+public:
+    // Constructor sizing the filter for capacity keys with a false-positive rate of about falsePositiveRate
+    explicit ConcurrentCuckooFilter(size_t capacity, double falsePositiveRate = 0.003)
+        : fingerprintBits(bitsFor(falsePositiveRate)),
+          fingerprintMask((Word(1) << fingerprintBits) - 1),
+          buckets(static_cast<size_t>(capacity / (SLOTS_PER_BUCKET * MAX_LOAD)) + 1),
+          table(buckets),
+          stripes(LOCK_STRIPES)
+    {
+        for (auto &bucket : table)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+
+    ConcurrentCuckooFilter(const ConcurrentCuckooFilter &) = delete;
+    ConcurrentCuckooFilter &operator=(const ConcurrentCuckooFilter &) = delete;
+
+    // Add a key. Returns false if the filter is full; the filter is then left unchanged.
+    bool add(const T &key)
+    {
+        Word keyHash = hashKey(key);
+        Word tag = fingerprint(keyHash);
+        size_t i1 = bucketOf(keyHash);
+        size_t i2 = altBucket(i1, tag);
+        std::vector<Step> path;
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt)
+        {
+            acquire(i1, i2);
+            if (insertInto(i1, tag) || insertInto(i2, tag))
+            {
+                release(i1, i2);
+                count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            release(i1, i2);
+
+            // Both buckets are full: free a slot in one of them by displacement, then try again
+            if (findPath(attempt % 2 ? i2 : i1, path))
+                movePath(path);
+        }
+        return false;
+    }
+
+    // Remove one copy of a key that was added before. Returns false if no matching fingerprint was found.
+    bool remove(const T &key)
+    {
+        Word keyHash = hashKey(key);
+        Word tag = fingerprint(keyHash);
+        size_t i1 = bucketOf(keyHash);
+        size_t i2 = altBucket(i1, tag);
+        acquire(i1, i2);
+        for (size_t i : {i1, i2})
+        {
+            Word bucket = table[i].load(std::memory_order_relaxed);
+            int slot = find(bucket, tag);
+            if (slot >= 0)
+            {
+                table[i].store(withSlot(bucket, slot, 0), std::memory_order_release);
+                release(i1, i2);
+                count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        release(i1, i2);
+        return false;
+    }
+
+    // Check if the key might be in the filter, without taking any lock. A miss is only reported once both
+    // buckets were read without a displacement touching them in between.
+    bool contains(const T &key)
+    {
+        Word keyHash = hashKey(key);
+        Word tag = fingerprint(keyHash);
+        size_t i1 = bucketOf(keyHash);
+        size_t i2 = altBucket(i1, tag);
+        Stripe &s1 = stripeOf(i1);
+        Stripe &s2 = stripeOf(i2);
+        for (;;)
+        {
+            Word v1 = s1.version.load(std::memory_order_acquire);
+            Word v2 = s2.version.load(std::memory_order_acquire);
+            if ((v1 | v2) & 1) // A move is in progress on one of the stripes
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            if (find(table[i1].load(std::memory_order_acquire), tag) >= 0 ||
+                find(table[i2].load(std::memory_order_acquire), tag) >= 0)
+                return true;
+            std::atomic_thread_fence(std::memory_order_acquire); // The bucket loads happen before the version checks
+            if (s1.version.load(std::memory_order_relaxed) == v1 && s2.version.load(std::memory_order_relaxed) == v2)
+                return false;
+        }
+    }
+
+    // Count how many fingerprints are stored in the filter
+    int size() const
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    // Bits per fingerprint, as chosen from the false-positive rate
+    int fingerprint_bits() const
+    {
+        return fingerprintBits;
+    }
+
+    // Fraction of the slots in use
+    double load_factor() const
+    {
+        return static_cast<double>(size()) / (buckets * SLOTS_PER_BUCKET);
+    }
+
+    // Bytes held by the buckets and the lock stripes
+    size_t memory_usage() const
+    {
+        return buckets * sizeof(Word) + LOCK_STRIPES * sizeof(Stripe);
+    }
+};
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <vector>     // For std::vector (dynamic arrays)
+#include <functional> // For std::hash
+#include <ctime>      // For std::time (used for hashing seeds)
+#include <list>       // For std::list (the probe sets in each bucket)
+#include <mutex>      // For std::recursive_mutex (striped locks)
+#include <atomic>     // For the atomic capacity read before locking
+#include <memory>     // For std::unique_ptr
+#include <utility>    // For std::pair
+#include <optional>   // For std::optional (peeking at a probe set head)
+#include <cstdint>    // For std::uint64_t (the hash mix)
+
+// This class implements a thread-safe cuckoo hash map on top of the striped-locking engine of CuckooConcurrentSet.
+// Every key hashes to one probe set in each of the two tables, and both probe sets are covered by one lock stripe
+// per table. The read-modify-write operations (upsert, compute_if_present, find with a callback) run their callback
+// while those two stripes are held, so an atomic update costs one hashed lock acquisition and no external locking.
+// Callbacks must not call back into the same map.
+
+template <class K, class V>
+class CuckooConcurrentMap
+{
+private:
+    // Entry stores the key together with its value inside a probe set.
+    struct Entry
+    {
+        K key;   // The key used for hashing and comparisons
+        V value; // The payload associated with the key
+        Entry(const K &initKey, const V &initValue) : key(initKey), value(initValue) {}
+    };
+
+    using ProbeSet = std::list<Entry>; // The chain of entries stored in one bucket
+
+    const int PROBE_SIZE = 8;             // Size of the probing list in each hash table slot
+    const int THRESHOLD = PROBE_SIZE / 2; // Threshold of items in a slot before relocation is triggered
+    const int LIMIT = 16;                 // Maximum number of relocation attempts before resizing is triggered
+    std::atomic<int> capacity;            // The current size of each table
+    size_t salt0, salt1;                  // Salts used for the two hash functions; fixed for the life of the map
+    std::vector<std::vector<ProbeSet>> table;                             // Two rows of probe sets
+    std::vector<std::vector<std::unique_ptr<std::recursive_mutex>>> locks; // Lock stripes, one row per table
+
+    // Hash function that XORs std::hash with a salt and mixes the result (splitmix64 finalizer, so the two salts
+    // give independent indexes); both the probe set index and the lock stripe are taken from it
+    size_t salted(const K &key, size_t seed) const
+    {
+        std::uint64_t x = std::hash<K>{}(key) ^ seed;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Index of the key's probe set in table 0
+    int hash0(const K &key) const
+    {
+        return salted(key, salt0) % capacity.load(std::memory_order_relaxed);
+    }
+
+    // Index of the key's probe set in table 1
+    int hash1(const K &key) const
+    {
+        return salted(key, salt1) % capacity.load(std::memory_order_relaxed);
+    }
+
+    // The capacity is always the initial capacity times a power of two, so the stripe of a key never changes
+    // when the tables grow; locking by salted hash modulo the stripe count covers exactly one probe set per table.
+    std::recursive_mutex &lock0(const K &key) const
+    {
+        return *locks[0][salted(key, salt0) % locks[0].size()];
+    }
+
+    std::recursive_mutex &lock1(const K &key) const
+    {
+        return *locks[1][salted(key, salt1) % locks[1].size()];
+    }
+
+    // Acquire the stripes covering both probe sets of key (always table 0 first, then table 1)
+    void acquire(const K &key) const
+    {
+        lock0(key).lock();
+        lock1(key).lock();
+    }
+
+    // Release the stripes after modification
+    void release(const K &key) const
+    {
+        lock0(key).unlock();
+        lock1(key).unlock();
+    }
+
+    // Find the entry for key in one probe set; the caller holds the key's stripes
+    static typename ProbeSet::iterator locate(ProbeSet &probeSet, const K &key)
+    {
+        auto it = probeSet.begin();
+        while (it != probeSet.end() && !(it->key == key))
+            ++it;
+        return it;
+    }
+
+    // Find the entry for key in either table, or null; the caller holds the key's stripes
+    Entry *lookup(const K &key)
+    {
+        ProbeSet &set0 = table[0][hash0(key)];
+        auto it0 = locate(set0, key);
+        if (it0 != set0.end())
+            return &*it0;
+        ProbeSet &set1 = table[1][hash1(key)];
+        auto it1 = locate(set1, key);
+        if (it1 != set1.end())
+            return &*it1;
+        return nullptr;
+    }
+
+    // Outcome of trying to put a new entry into one of its two probe sets
+    enum class Placement
+    {
+        Done,     // The entry landed in a probe set below the threshold
+        Relocate, // The entry landed in a crowded probe set; relocate(i, h) should run after releasing the locks
+        Resize    // Both probe sets are full; the table has to grow
+    };
+
+    // Put a new entry for key into table 0 or table 1; the caller holds the key's stripes
+    Placement place(const K &key, const V &value, int &i, int &h)
+    {
+        int h0 = hash0(key);
+        int h1 = hash1(key);
+        size_t threshold = THRESHOLD;
+        size_t probeSize = PROBE_SIZE;
+        if (table[0][h0].size() < threshold)
+        {
+            table[0][h0].emplace_back(key, value);
+            return Placement::Done;
+        }
+        if (table[1][h1].size() < threshold)
+        {
+            table[1][h1].emplace_back(key, value);
+            return Placement::Done;
+        }
+        if (table[0][h0].size() < probeSize)
+        {
+            table[0][h0].emplace_back(key, value);
+            i = 0;
+            h = h0;
+            return Placement::Relocate;
+        }
+        if (table[1][h1].size() < probeSize)
+        {
+            table[1][h1].emplace_back(key, value);
+            i = 1;
+            h = h1;
+            return Placement::Relocate;
+        }
+        return Placement::Resize;
+    }
+
+    // Move entries out of the crowded probe set table[i][hi] until it is back under the threshold
+    bool relocate(int i, int hi)
+    {
+        for (int round = 0; round < LIMIT; round++)
+        {
+            // Peek at the oldest entry under its own stripe, then lock both of its stripes in the usual order
+            std::optional<K> head;
+            {
+                std::lock_guard<std::recursive_mutex> guard(*locks[i][hi % locks[i].size()]);
+                if (table[i][hi].size() < static_cast<size_t>(THRESHOLD))
+                    return true; // Someone else already drained the probe set
+                head.emplace(table[i][hi].front().key);
+            }
+            const K &key = *head;
+
+            acquire(key);
+            if (i == 0 ? hash0(key) != hi : hash1(key) != hi) // The table grew in between; its resize rebalanced it
+            {
+                release(key);
+                return true;
+            }
+            int j = 1 - i;
+            int hj = (j == 0) ? hash0(key) : hash1(key);
+            auto it = locate(table[i][hi], key);
+            if (it == table[i][hi].end()) // The entry was erased in between; look at the new head
+            {
+                bool drained = table[i][hi].size() < static_cast<size_t>(THRESHOLD);
+                release(key);
+                if (drained)
+                    return true;
+                continue;
+            }
+            if (table[j][hj].size() < static_cast<size_t>(THRESHOLD))
+            {
+                table[j][hj].splice(table[j][hj].end(), table[i][hi], it); // Move the node without copying it
+                release(key);
+                return true;
+            }
+            if (table[j][hj].size() < static_cast<size_t>(PROBE_SIZE))
+            {
+                table[j][hj].splice(table[j][hj].end(), table[i][hi], it);
+                release(key);
+                i = j; // The other probe set is now the crowded one
+                hi = hj;
+                continue;
+            }
+            release(key);
+            return false; // Both probe sets are full
+        }
+        return false; // After max attempts, the table has to grow
+    }
+
+    // Grow the tables until every entry fits; the caller must not hold any stripe
+    void resize()
+    {
+        int oldCapacity = capacity.load();
+        for (auto &row : locks) // Take every stripe, table 0 first, so no probe set is read while it moves
+            for (auto &lock : row)
+                lock->lock();
+
+        if (capacity.load() == oldCapacity) // Otherwise another thread already grew the table
+        {
+            ProbeSet all; // Splice every node into one list so entries are never copied
+            for (auto &row : table)
+                for (auto &probeSet : row)
+                    all.splice(all.end(), probeSet);
+
+            int newCapacity = oldCapacity;
+            bool placed = false;
+            while (!placed)
+            {
+                newCapacity *= 2;
+                capacity.store(newCapacity);
+                table.assign(2, std::vector<ProbeSet>(newCapacity));
+
+                placed = true;
+                while (!all.empty())
+                {
+                    const K &key = all.front().key;
+                    ProbeSet &set0 = table[0][hash0(key)];
+                    ProbeSet &set1 = table[1][hash1(key)];
+                    ProbeSet &target = set0.size() <= set1.size() ? set0 : set1;
+                    if (target.size() >= static_cast<size_t>(PROBE_SIZE))
+                    {
+                        placed = false;
+                        break;
+                    }
+                    target.splice(target.end(), all, all.begin());
+                }
+                if (!placed) // Gather everything back and try again with twice the room
+                    for (auto &row : table)
+                        for (auto &probeSet : row)
+                            all.splice(all.end(), probeSet);
+            }
+        }
+
+        for (auto &row : locks)
+            for (auto &lock : row)
+                lock->unlock();
+    }
+
+    // Shared body of insert, insert_or_assign and upsert: run onFound on the value if the key is present,
+    // otherwise insert the value produced by makeValue. Returns true if a new key was inserted.
+    template <typename OnFound, typename MakeValue>
+    bool upsertImpl(const K &key, OnFound onFound, MakeValue makeValue)
+    {
+        for (;;)
+        {
+            acquire(key);
+            if (Entry *entry = lookup(key))
+            {
+                onFound(entry->value);
+                release(key);
+                return false;
+            }
+
+            int i = -1;
+            int h = -1;
+            Placement placement = place(key, makeValue(), i, h);
+            release(key);
+
+            if (placement == Placement::Done)
+                return true;
+            if (placement == Placement::Relocate)
+            {
+                if (!relocate(i, h))
+                    resize(); // The entry is already stored; grow so the crowded probe sets drain
+                return true;
+            }
+            resize(); // Nothing was stored; grow and try again
+        }
+    }
+
+public:
+    CuckooConcurrentMap(int initial_capacity = 32)
+        : capacity(initial_capacity),
+          salt0(time(NULL)),              // Initialize salt0 with current time
+          salt1(time(NULL) ^ 0x9e3779b9) // Use XOR of time for salt1 so the two tables hash differently
+    {
+        for (int i = 0; i < 2; i++) // Initialize two tables and their lock stripes
+        {
+            std::vector<std::unique_ptr<std::recursive_mutex>> locks_row;
+            for (int j = 0; j < initial_capacity; j++)
+                locks_row.push_back(std::make_unique<std::recursive_mutex>());
+            table.push_back(std::vector<ProbeSet>(initial_capacity));
+            locks.push_back(std::move(locks_row));
+        }
+    }
+
+    // Insert the pair if the key is absent. Returns false (and leaves the old value) if the key exists.
+    bool insert(const K &key, const V &value)
+    {
+        return upsertImpl(key, [](V &) {}, [&]() -> const V & { return value; });
+    }
+
+    // Insert the pair, or overwrite the value if the key exists. Returns true if a new key was inserted.
+    bool insert_or_assign(const K &key, const V &value)
+    {
+        return upsertImpl(key, [&](V &current) { current = value; }, [&]() -> const V & { return value; });
+    }
+
+    // If the key is present, call fn(value) under the key's stripes; otherwise insert value.
+    // Returns true if a new key was inserted.
+    template <typename F>
+    bool upsert(const K &key, F fn, const V &value)
+    {
+        return upsertImpl(key, fn, [&]() -> const V & { return value; });
+    }
+
+    // If the key is present, call fn(value) under the key's stripes and return true.
+    template <typename F>
+    bool compute_if_present(const K &key, F fn)
+    {
+        acquire(key);
+        Entry *entry = lookup(key);
+        if (entry)
+            fn(entry->value);
+        release(key);
+        return entry != nullptr;
+    }
+
+    // If the key is present, call fn(const value) under the key's stripes and return true.
+    template <typename F>
+    bool find(const K &key, F fn)
+    {
+        acquire(key);
+        Entry *entry = lookup(key);
+        if (entry)
+            fn(static_cast<const V &>(entry->value));
+        release(key);
+        return entry != nullptr;
+    }
+
+    // Check if the key is present in the map.
+    bool contains(const K &key)
+    {
+        acquire(key);
+        bool found = lookup(key) != nullptr;
+        release(key);
+        return found;
+    }
+
+    // Remove the key and its value. Returns false if the key is absent.
+    bool erase(const K &key)
+    {
+        acquire(key);
+        for (int i = 0; i < 2; i++)
+        {
+            ProbeSet &probeSet = table[i][i == 0 ? hash0(key) : hash1(key)];
+            auto it = locate(probeSet, key);
+            if (it != probeSet.end())
+            {
+                probeSet.erase(it);
+                release(key);
+                return true;
+            }
+        }
+        release(key);
+        return false;
+    }
+
+    // Count the stored pairs (non-thread-safe).
+    int size() const
+    {
+        int size = 0;
+        for (const auto &row : table)
+            for (const auto &probeSet : row)
+                size += probeSet.size();
+        return size;
+    }
+
+    // Insert a list of pairs. Returns the number of new keys inserted.
+    int populate(const std::vector<std::pair<K, V>> &list)
+    {
+        int added = 0;
+        for (const auto &kv : list)
+        {
+            if (insert(kv.first, kv.second))
+                added++;
+        }
+        return added;
+    }
+};
@@ -6,119 +6,180 @@
 #include <mutex>      // Include the mutex library for thread synchronization
 #include <atomic>     // Include the atomic library for thread-safe atomic operations
 #include <thread>     // Include the thread library for multi-threading operations
+#include <utility>    // Include the utility library for std::move and std::forward
+#include <algorithm>  // Include the algorithm library for std::find_if
+#include <cstdint>    // Include the fixed-width integers for the hash mix
+
+#include "cuckoo-hash.h"   // Include the shared hashing helpers (transparent lookup, stored hashes)
+#include "cuckoo-memory.h" // Include the allocator helpers for nodes, tables and locks
+#include "cuckoo-parallel.h" // Include the helpers for the parallel bulk build
+#include "frozen-cuckoo.h"   // Include the immutable set returned by freeze()
+#include "cuckoo-bloom.h"    // Include the optional prefilter in front of contains
 
 // This class implements a thread-safe cuckoo hash set, where two hash tables
 // are used with probing. Each operation (add, remove, contains) is synchronized
 // using locks to ensure safety in a multi-threaded environment. The set handles
 // collisions and ensures there is no data corruption by using striped locking for concurrency.
 
-template <class T>
+// Hash and KeyEqual default to std::hash<T> and std::equal_to<T>. If both are transparent (see cuckoo-hash.h),
+// contains and remove also accept any key type they understand, without constructing a temporary T.
+// With StoreHash (the default for non-scalar T), each list node keeps the value's full hash: probes compare it
+// before KeyEqual, and relocation and resizing reuse it instead of calling Hash again.
+// List nodes, table rows and lock arrays are all allocated with Allocator (see cuckoo-memory.h).
+template <class T, class Hash = std::hash<T>, class KeyEqual = std::equal_to<T>, class Allocator = std::allocator<T>,
+          bool StoreHash = StoreHashByDefault<T>::value>
 class CuckooConcurrentSet
 {
 private:
+    using Node = StoredValue<T, Hash, StoreHash>;                        // A value (and its hash, with StoreHash) held in a list node
+    using ProbeSet = std::list<Node, RebindAlloc<Allocator, Node>>;      // The probing list of one table slot
+    using Row = std::vector<ProbeSet, RebindAlloc<Allocator, ProbeSet>>; // One hash table
+    using LockRow = std::vector<std::recursive_mutex, RebindAlloc<Allocator, std::recursive_mutex>>; // The lock stripes of one table
+
     bool is_resizing = false; // Flag to track if resizing is happening to avoid recursion
 
     const int PROBE_SIZE = 8;                                              // Size of the probing list in each hash table slot
     const int THRESHOLD = PROBE_SIZE / 2;                                  // Threshold of items in a slot before relocation is triggered
     const int LIMIT = 16;                                                  // Maximum number of relocation attempts before resizing is triggered
+    const int RESERVE_LOAD = THRESHOLD / 2;                                // Average values per slot that reserve() plans for
     int capacity;                                                          // The current size of the table
     size_t salt0, salt1;                                                   // Salts used for the hashing functions for randomness
-    std::vector<std::vector<std::list<T>>> table;                          // The hash table, represented as two vector rows of linked lists
-    std::vector<std::vector<std::unique_ptr<std::recursive_mutex>>> locks; // Locks for synchronization
+    Allocator alloc;                                                       // The allocator everything is rebound from
+    std::vector<Row, RebindAlloc<Allocator, Row>> table;                   // The hash table, represented as two vector rows of linked lists
+    LockRow locks[2];                                                      // Locks for synchronization (the mutexes never move)
+    std::atomic<BlockedBloomFilter *> prefilter{nullptr};                  // Optional prefilter read by contains without locks (null when disabled)
+    std::vector<std::unique_ptr<BlockedBloomFilter>> prefilters;           // Every prefilter built so far; the last one is current
+    int prefilterBitsPerKey = 0;                                           // Bits per key the prefilter is sized with (0 when disabled)
 
-    // Hash function that XORs std::hash with a salt and takes modulo capacity
-    int hash(const T &key, size_t seed) const
+    // Hash function that XORs a key's Hash value with a salt, mixes the result (splitmix64 finalizer, so the two
+    // salts give independent indexes) and takes modulo capacity
+    // Each operation hashes its key once and passes the result around
+    int hash(size_t keyHash, size_t seed) const
     {
-        return (std::hash<T>{}(key) ^ seed) % capacity; // Combine std::hash of key with salt and modulo by capacity
+        std::uint64_t x = keyHash ^ seed; // Combine the key's hash with salt
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return (x ^ (x >> 31)) % capacity; // Modulo by capacity
     }
 
     // First hash function using salt1
-    int hash1(const T &key) const
+    int hash1(size_t keyHash) const
     {
-        return hash(key, salt1); // Using salt1 for the first hash
+        return hash(keyHash, salt1); // Using salt1 for the first hash
     }
 
     // Second hash function using salt0
-    int hash2(const T &key) const
+    int hash2(size_t keyHash) const
+    {
+        return hash(keyHash, salt0); // Using salt0 for the second hash
+    }
+
+    // Find the element equal to key (whose Hash value is keyHash) in one probe set
+    // K is T, or any type accepted by a transparent Hash and KeyEqual
+    template <typename K>
+    static typename ProbeSet::iterator locate(ProbeSet &probe_set, const K &key, size_t keyHash)
     {
-        return hash(key, salt0); // Using salt0 for the second hash
+        return std::find_if(probe_set.begin(), probe_set.end(), [&](const Node &node)
+                            { return node.hashMatches(keyHash) && KeyEqual{}(node.value, key); });
     }
 
     // Relocate an element if a bucket overflows
     // i is the current table
     // hi is the index in the current table
+    // Elements are moved between buckets by splicing their list node, so the value itself is never copied.
     bool relocate(int i, int hi)
     {
-        int hj = 0;                                 // Holds the index of the bucket in the other table
-        int j = 1 - i;                              // The other table (0 or 1)
+        int j = 1 - i; // The other table (0 or 1)
         for (int round = 0; round < LIMIT; round++) // Try relocating multiple times if needed
         {
-            T val = table[i][hi].front(); // Get the value at the head of the list in the current bucket
-            switch (i)                    // Choose the hash function based on which table we're working with
+            // Find the lock stripes of the element at the head of the bucket. The bucket is covered by
+            // locks[i][hi % locks[i].size()], so peek under that stripe alone and only hash the head in place.
+            size_t l0, l1;
             {
-            case 0:
-                hj = hash1(val); // Use hash1 for the first table
-                break;
-            case 1:
-                hj = hash2(val); // Use hash2 for the second table
-                break;
+                std::lock_guard<std::recursive_mutex> guard(locks[i][hi % locks[i].size()]);
+                if (table[i][hi].size() < static_cast<size_t>(THRESHOLD)) // Someone else already drained it
+                    return true;
+                size_t head = table[i][hi].front().hash();
+                l0 = hash1(head) % locks[0].size();
+                l1 = hash2(head) % locks[1].size();
             }
-            acquire(val);                                                       // Acquire the lock to synchronize access to the current element
-            auto it = std::find(table[i][hi].begin(), table[i][hi].end(), val); // Search for the value in the current table slot
-            if (it != table[i][hi].end())                                       // If the value was found
+
+            locks[0][l0].lock(); // Acquire both stripes of the head element (table 0 first, as in acquire)
+            locks[1][l1].lock();
+            auto it = table[i][hi].begin();
+            if (it == table[i][hi].end() || hash1(it->hash()) % locks[0].size() != l0 || hash2(it->hash()) % locks[1].size() != l1)
             {
-                table[i][hi].erase(it);              // Remove the value from the current slot
-                if (table[j][hj].size() < THRESHOLD) // If the other slot is under the threshold
-                {
-                    table[j][hj].push_back(val); // Move the value to the other table's slot
-                    release(val);                // Release the lock after moving the value
+                // The head changed while no lock was held; look again unless the bucket drained meanwhile
+                bool drained = table[i][hi].size() < static_cast<size_t>(THRESHOLD);
+                locks[0][l0].unlock();
+                locks[1][l1].unlock();
+                if (drained)
                     return true;
-                }
-                else if (table[j][hj].size() < PROBE_SIZE) // If the slot has room for more values
-                {
-                    table[j][hj].push_back(val); // Place the value in the other slot
-                    i = 1 - i;                   // Swap tables and continue relocating
-                    hi = hj;
-                    j = 1 - j;
-                    release(val); // Release the lock before continuing to the next iteration
-                }
-                else // If both slots are full, return false
-                {
-                    table[i][hi].push_back(val);
-                    release(val); // Release the lock
-                    return false;
-                }
+                continue;
             }
-            else if (table[i][hi].size() >= THRESHOLD) // If the current slot is over the threshold
+
+            int hj = (j == 0) ? hash1(it->hash()) : hash2(it->hash()); // Index of the element's bucket in the other table
+            bool moved = false;
+            bool done = false;
+            if (table[j][hj].size() < static_cast<size_t>(THRESHOLD)) // If the other slot is under the threshold
             {
-                release(val); // Release the lock
-                continue;     // Try relocating again
+                table[j][hj].splice(table[j][hj].end(), table[i][hi], it); // Move the node to the other table's slot
+                moved = done = true;
             }
-            else // If relocation is successful
+            else if (table[j][hj].size() < static_cast<size_t>(PROBE_SIZE)) // If the slot has room for more values
             {
-                release(val); // Release the lock
-                return true;  // Successfully relocated
+                table[j][hj].splice(table[j][hj].end(), table[i][hi], it); // Move it, then keep relocating from there
+                moved = true;
             }
+            locks[0][l0].unlock(); // Release the stripes after moving the value
+            locks[1][l1].unlock();
+
+            if (done)
+                return true;
+            if (!moved) // If both slots are full, return false
+                return false;
+            i = 1 - i; // Swap tables and continue relocating
+            hi = hj;
+            j = 1 - j;
         }
         return false; // After max attempts, return false if relocation failed
     }
 
+    // Slots per table needed to hold n values at RESERVE_LOAD values per slot
+    int capacityFor(size_t n) const
+    {
+        return static_cast<int>(n / (2 * RESERVE_LOAD)) + 1;
+    }
+
     // Acquire locks for both tables before modifying them
-    void acquire(const T &val)
+    // A resize that ran between choosing the stripes and locking them may have changed the salts or the capacity,
+    // and with them the key's stripes; then the locks taken do not cover the key (and release would unlock others),
+    // so drop them and try again. Once one of them is held no resize can start, so the stripes stay put.
+    void acquire(size_t keyHash)
     {
-        locks[0][hash1(val) % locks[0].size()]->lock(); // Lock the first table slot
-        locks[1][hash2(val) % locks[1].size()]->lock(); // Lock the second table slot
+        for (;;)
+        {
+            size_t l0 = hash1(keyHash) % locks[0].size();
+            size_t l1 = hash2(keyHash) % locks[1].size();
+            locks[0][l0].lock(); // Lock the first table slot
+            locks[1][l1].lock(); // Lock the second table slot
+            if (hash1(keyHash) % locks[0].size() == l0 && hash2(keyHash) % locks[1].size() == l1)
+                return;
+            locks[0][l0].unlock();
+            locks[1][l1].unlock();
+        }
     }
 
     // Release the locks after modification
-    void release(const T &val)
+    void release(size_t keyHash)
     {
-        locks[0][hash1(val) % locks[0].size()]->unlock(); // Unlock the first table slot
-        locks[1][hash2(val) % locks[1].size()]->unlock(); // Unlock the second table slot
+        locks[0][hash1(keyHash) % locks[0].size()].unlock(); // Unlock the first table slot
+        locks[1][hash2(keyHash) % locks[1].size()].unlock(); // Unlock the second table slot
     }
 
     // Resize the table when it exceeds capacity
-    void resize()
+    // The table grows to newCapacity slots per table, or doubles when newCapacity is 0
+    void resize(int newCapacity = 0)
     {
         // Prevent recursion into add during resize
         if (is_resizing)
@@ -127,11 +188,18 @@ private:
         int oldCapacity = capacity;
         for (auto &lock : locks[0]) // Lock all entries of the first table
         {
-            lock->lock();
+            lock.lock();
+        }
+        for (auto &lock : locks[1]) // And of the second: relocate peeks at a table-1 bucket under its stripe alone
+        {
+            lock.lock();
         }
 
         if (capacity != oldCapacity) // Check if resizing already happened
         {
+            for (auto &row : locks)
+                for (auto &lock : row)
+                    lock.unlock();
             return;
         }
 
@@ -139,112 +207,118 @@ private:
         is_resizing = true;
 
         salt0 = time(NULL); // Update salt0 with current time
-        salt1 = salt0;      // Set salt1 the same as salt0
+        salt1 = salt0 ^ 0x9e3779b9; // Derive a different salt1, so the two tables use different hash functions
 
-        capacity *= 2;                                           // Double the capacity
-        std::vector<std::vector<std::list<T>>> old_table(table); // Save old table for re-insertion
-        table.clear();                                           // Clear the current table
+        capacity = newCapacity > 0 ? newCapacity : capacity * 2;             // Double the capacity (or use the requested one)
+        std::vector<Row, RebindAlloc<Allocator, Row>> old_table(std::move(table)); // Take over the old table for re-insertion
+        table.clear();                                                      // Clear the current table
 
         // Rebuild the table with new capacity
         for (int i = 0; i < 2; i++)
         {
-            std::vector<std::list<T>> row;
-            for (int j = 0; j < capacity; j++)
-            {
-                row.push_back(std::list<T>());
-            }
-            table.push_back(row);
+            table.push_back(Row(capacity, ProbeSet(alloc), alloc));
         }
 
-        // Re-insert all old elements back into the new table
+        rebuildPrefilter(old_table); // Readers switch to a prefilter of the same values before they move
+
+        // Re-insert all old elements back into the new table, moving each value and reusing its hash
         for (auto &row : old_table)
         {
             for (auto &probe_set : row)
             {
                 for (auto &entry : probe_set)
                 {
-                    add(entry); // Recursively handle resizing during re-insertion
+                    insert(entry.hash(), std::move(entry.value)); // Recursively handle resizing during re-insertion
                 }
             }
         }
 
-        for (auto &lock : locks[0]) // Release all locks after resizing
+        is_resizing = false; // Later resizes may run again
+
+        for (auto &row : locks) // Release all locks after resizing
         {
-            lock->unlock();
+            for (auto &lock : row)
+                lock.unlock();
         }
     }
 
-public:
-    CuckooConcurrentSet(int initial_capacity) : capacity(initial_capacity)
+    // Build a new prefilter (if enabled) from the values in rows, sized for the current capacity, and publish it
+    // Readers may still hold an older prefilter, so older ones are kept until the set is destroyed; each resize
+    // doubles the size, so together they take less memory than the current one
+    // Must be called with all of locks[0] held
+    template <typename Rows>
+    void rebuildPrefilter(const Rows &rows)
     {
-        for (int i = 0; i < 2; i++) // Initialize two hash tables
+        if (prefilterBitsPerKey == 0)
+            return;
+        prefilters.emplace_back(new BlockedBloomFilter(2 * capacity * THRESHOLD, prefilterBitsPerKey));
+        for (const auto &row : rows)
         {
-            std::vector<std::list<T>> row;
-            std::vector<std::unique_ptr<std::recursive_mutex>> locks_row;
-            for (int j = 0; j < capacity; j++) // Initialize capacity for each table slot
+            for (const auto &probe_set : row)
             {
-                row.push_back(std::list<T>());
-                locks_row.push_back(std::make_unique<std::recursive_mutex>());
+                for (const auto &node : probe_set)
+                {
+                    prefilters.back()->insert(node.hash());
+                }
             }
-            table.push_back(row);
-            locks.push_back(std::move(locks_row));
         }
-        salt0 = time(NULL); // Initialize salt0 with current time
-        salt1 = salt0;      // Set salt1 to the same value as salt0
+        prefilter.store(prefilters.back().get(), std::memory_order_release);
     }
 
-    bool add(const T &val)
+    // Shared body of add(const T&) and add(T&&). U is const T& or T, and keyHash is Hash{}(val); the value
+    // is forwarded into the bucket only once it is known to be new, and is left untouched if the add has to be retried.
+    template <typename U>
+    bool insert(size_t keyHash, U &&val)
     {
-        acquire(val);        // Lock both tables before modifying
-        int h0 = hash1(val); // Compute hash1 for the first table
-        int h1 = hash2(val); // Compute hash2 for the second table
+        acquire(keyHash);        // Lock both tables before modifying
+        int h0 = hash1(keyHash); // Compute hash1 for the first table
+        int h1 = hash2(keyHash); // Compute hash2 for the second table
         int i = -1;
         int h = -1;
-        bool mustResize = false; // Flag to check if resizing is needed
 
-        if (contains(val)) // Check if the value already exists
+        if (containsKey(val, keyHash)) // Check if the value already exists
         {
-            release(val); // Release the locks before returning
+            release(keyHash); // Release the locks before returning
             return false;
         }
 
         // Attempt to add the value to the first or second table
-        if (table[0][h0].size() < THRESHOLD)
+        ProbeSet *target = nullptr;
+        if (table[0][h0].size() < static_cast<size_t>(THRESHOLD))
         {
-            table[0][h0].push_back(val);
-            release(val);
-            return true;
+            target = &table[0][h0];
         }
-        else if (table[1][h1].size() < THRESHOLD)
+        else if (table[1][h1].size() < static_cast<size_t>(THRESHOLD))
         {
-            table[1][h1].push_back(val);
-            release(val);
-            return true;
+            target = &table[1][h1];
         }
-        else if (table[0][h0].size() < PROBE_SIZE)
+        else if (table[0][h0].size() < static_cast<size_t>(PROBE_SIZE))
         {
-            table[0][h0].push_back(val);
+            target = &table[0][h0];
             i = 0;
             h = h0;
         }
-        else if (table[1][h1].size() < PROBE_SIZE)
+        else if (table[1][h1].size() < static_cast<size_t>(PROBE_SIZE))
         {
-            table[1][h1].push_back(val);
+            target = &table[1][h1];
             i = 1;
             h = h1;
         }
-        else
-        {
-            mustResize = true; // Set flag to resize if both slots are full
-        }
-        release(val);
 
-        if (mustResize) // Resize if needed
+        if (target == nullptr) // Both slots are full: resize and retry
         {
+            release(keyHash);
             resize();
-            add(val); // Retry after resizing
+            return insert(keyHash, std::forward<U>(val)); // val was not consumed, so it can be forwarded again
         }
-        else if (!relocate(i, h)) // Relocate the element if needed
+
+        BlockedBloomFilter *filter = prefilter.load(std::memory_order_relaxed); // Stable: changing it takes every lock
+        if (filter && !is_resizing) // During a resize the new prefilter already has every value
+            filter->insert(keyHash); // Before the value is visible, so a reader never misses it
+        target->emplace_back(keyHash, std::in_place, std::forward<U>(val)); // val may be moved-from after this line
+        release(keyHash);
+
+        if (i != -1 && !relocate(i, h)) // Relocate an element if the bucket went over the threshold
         {
             resize(); // Resize the table if relocation fails
         }
@@ -252,41 +326,120 @@ public:
         return true; // Successfully added the value
     }
 
-    bool remove(const T &val)
+    // Remove the value equal to val if it is present
+    template <typename K>
+    bool removeKey(const K &val)
     {
-        acquire(val);        // Lock both tables before modifying
-        int h0 = hash1(val); // Compute hash1 for the first table
-        int h1 = hash2(val); // Compute hash2 for the second table
-        auto it0 = std::find(table[0][h0].begin(), table[0][h0].end(), val);
+        size_t keyHash = Hash{}(val); // Hash the key once for the whole operation
+        acquire(keyHash);             // Lock both tables before modifying
+        int h0 = hash1(keyHash);      // Compute hash1 for the first table
+        int h1 = hash2(keyHash);      // Compute hash2 for the second table
+        auto it0 = locate(table[0][h0], val, keyHash);
         if (it0 != table[0][h0].end()) // Check if the value is found in the first table
         {
             table[0][h0].erase(it0); // Remove the value
-            release(val);            // Release the locks before returning
+            release(keyHash);        // Release the locks before returning
             return true;
         }
         else
         {
-            auto it1 = std::find(table[1][h1].begin(), table[1][h1].end(), val);
+            auto it1 = locate(table[1][h1], val, keyHash);
             if (it1 != table[1][h1].end()) // Check if the value is found in the second table
             {
                 table[1][h1].erase(it1); // Remove the value
-                release(val);            // Release the locks before returning
+                release(keyHash);        // Release the locks before returning
                 return true;
             }
         }
-        release(val); // Release the locks if the value is not found
+        release(keyHash); // Release the locks if the value is not found
         return false;
     }
 
-    bool contains(const T &val)
+    // Check whether a value equal to val (whose Hash value is keyHash) is present
+    template <typename K>
+    bool containsKey(const K &val, size_t keyHash)
     {
-        acquire(val); // Lock both tables before modifying
-        bool found = std::find(table[0][hash1(val)].begin(), table[0][hash1(val)].end(), val) != table[0][hash1(val)].end() ||
-                     std::find(table[1][hash2(val)].begin(), table[1][hash2(val)].end(), val) != table[1][hash2(val)].end();
-        release(val); // Release the locks after checking
+        BlockedBloomFilter *filter = prefilter.load(std::memory_order_acquire);
+        if (filter && !filter->mayContain(keyHash)) // Definitely absent: no lock is taken
+            return false;
+
+        acquire(keyHash); // Lock both tables before reading
+        int h0 = hash1(keyHash);
+        int h1 = hash2(keyHash);
+        bool found = locate(table[0][h0], val, keyHash) != table[0][h0].end() ||
+                     locate(table[1][h1], val, keyHash) != table[1][h1].end();
+        release(keyHash); // Release the locks after checking
         return found; // Return whether the value was found
     }
 
+public:
+    CuckooConcurrentSet(int initial_capacity, const Allocator &alloc = Allocator())
+        : capacity(initial_capacity), alloc(alloc), table(alloc),
+          locks{LockRow(initial_capacity, alloc), LockRow(initial_capacity, alloc)} // One lock per table slot
+    {
+        for (int i = 0; i < 2; i++) // Initialize two hash tables
+        {
+            table.push_back(Row(capacity, ProbeSet(alloc), alloc)); // One empty probe set per table slot
+        }
+        salt0 = time(NULL); // Initialize salt0 with current time
+        salt1 = salt0 ^ 0x9e3779b9; // Derive a different salt1, so the two tables use different hash functions
+    }
+
+    CuckooConcurrentSet(const CuckooConcurrentSet &) = delete;
+    CuckooConcurrentSet &operator=(const CuckooConcurrentSet &) = delete;
+
+    // The allocator the set was constructed with
+    Allocator get_allocator() const
+    {
+        return alloc;
+    }
+
+    // Add a value (copied once into its list node)
+    bool add(const T &val)
+    {
+        return insert(Hash{}(val), val);
+    }
+
+    // Add a value, moving it into its list node instead of copying it
+    bool add(T &&val)
+    {
+        size_t keyHash = Hash{}(val);
+        return insert(keyHash, std::move(val));
+    }
+
+    // Construct a value from args and add it; the value is built once and then moved into its node
+    template <typename... Args>
+    bool emplace(Args &&...args)
+    {
+        T val(std::forward<Args>(args)...);
+        size_t keyHash = Hash{}(val);
+        return insert(keyHash, std::move(val));
+    }
+
+    bool remove(const T &val)
+    {
+        return removeKey(val);
+    }
+
+    // Remove the value equal to key (only with a transparent Hash and KeyEqual)
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool remove(const K &key)
+    {
+        return removeKey(key);
+    }
+
+    bool contains(const T &val)
+    {
+        return containsKey(val, Hash{}(val));
+    }
+
+    // Check if a value equal to key is present (only with a transparent Hash and KeyEqual)
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool contains(const K &key)
+    {
+        return containsKey(key, Hash{}(key));
+    }
+
     int size() const
     {
         int size = 0;
@@ -300,8 +453,62 @@ public:
         return size; // Return the total size of the hash set
     }
 
+    // Put a blocked Bloom filter (see cuckoo-bloom.h) in front of contains, so most misses return without taking
+    // any lock. It is kept up to date by every add and rebuilt on every resize
+    void enable_prefilter(int bitsPerKey = 10)
+    {
+        for (auto &lock : locks[0]) // Block every operation, as in resize
+        {
+            lock.lock();
+        }
+        prefilterBitsPerKey = bitsPerKey;
+        rebuildPrefilter(table);
+        for (auto &lock : locks[0])
+        {
+            lock.unlock();
+        }
+    }
+
+    // Drop the prefilter; contains takes the locks again for every key
+    void disable_prefilter()
+    {
+        for (auto &lock : locks[0])
+        {
+            lock.lock();
+        }
+        prefilterBitsPerKey = 0;
+        prefilter.store(nullptr, std::memory_order_release); // The old prefilter stays allocated for readers still using it
+        for (auto &lock : locks[0])
+        {
+            lock.unlock();
+        }
+    }
+
+    // Whether contains is prefiltered
+    bool has_prefilter() const
+    {
+        return prefilter.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    // Presize the table for n values, so adding them does not have to resize on the way
+    void reserve(size_t n)
+    {
+        int needed = capacityFor(n);
+        if (needed > capacity)
+            resize(needed);
+    }
+
+    // Rebuild the table with newCapacity slots per table (or more, if the current values need it) and new salts
+    void rehash(int newCapacity)
+    {
+        int needed = capacityFor(size());
+        resize(newCapacity > needed ? newCapacity : needed);
+    }
+
+    // Add a list of values; the table is presized for the whole list first
     int populate(const std::vector<T> &list)
     {
+        reserve(size() + list.size());
         int added = 0;
         for (const T &value : list)
         {
@@ -312,4 +519,109 @@ public:
         }
         return added; // Return the number of values successfully added
     }
+
+    // Add a list of values using the given number of threads (the parallel bulk build described in cuckoo-parallel.h)
+    // Values are first placed without any locking, one table at a time, so no other operation may run on the set
+    // meanwhile, and the allocator must be thread-safe. Values that fit in neither bucket go through the locking add.
+    int populate(const std::vector<T> &list, int threads)
+    {
+        if (threads <= 1)
+            return populate(list);
+        reserve(size() + list.size());
+
+        BulkPartitions parts = partitionKeys(list, threads, capacity, [](const T &value)
+                                             { return Hash{}(value); }, [this](size_t keyHash)
+                                             { return hash1(keyHash); });
+        std::vector<int> added(threads, 0); // Successful additions per thread
+
+        for (int i = 0; i < 2; i++) // One lock-free round per table
+        {
+            BulkPartitions next(threads, std::vector<std::vector<BulkKey>>(threads));
+            runParallel(threads, [&](int p)
+                        {
+                for (int t = 0; t < threads; t++)
+                {
+                    for (const BulkKey &key : parts[t][p])
+                    {
+                        const T &value = list[key.first];
+                        int h0 = hash1(key.second);
+                        int h1 = hash2(key.second);
+                        if (locate(table[0][h0], value, key.second) != table[0][h0].end() ||
+                            locate(table[1][h1], value, key.second) != table[1][h1].end())
+                            continue; // Already present; only partition p writes to this key's bucket in this round
+
+                        ProbeSet &probe_set = table[i][i == 0 ? h0 : h1];
+                        if (probe_set.size() < static_cast<size_t>(THRESHOLD))
+                        {
+                            if (BlockedBloomFilter *filter = prefilter.load(std::memory_order_relaxed))
+                                filter->insert(key.second);
+                            probe_set.emplace_back(key.second, std::in_place, value);
+                            added[p]++;
+                        }
+                        else
+                        {
+                            next[p][partitionOf(h1, capacity, threads)].push_back(key); // Try the second table next
+                        }
+                    }
+                } });
+            parts.swap(next);
+        }
+
+        // Final pass: the values left over go through the normal locking insert, relocating or resizing as needed
+        runParallel(threads, [&](int p)
+                    {
+            for (int t = 0; t < threads; t++)
+                for (const BulkKey &key : parts[t][p])
+                    if (insert(key.second, list[key.first]))
+                        added[p]++; });
+
+        int total = 0;
+        for (int count : added)
+            total += count;
+        return total;
+    }
+
+    // Copy the values into an immutable FrozenCuckooSet, whose contains needs no locks at all
+    // All lock stripes are held meanwhile (as in resize), so the copy is a consistent snapshot
+    FrozenCuckooSet<T, Hash, KeyEqual, Allocator> freeze()
+    {
+        for (auto &lock : locks[0]) // Every operation takes a table-0 stripe, so these block them all
+        {
+            lock.lock();
+        }
+
+        std::vector<T, Allocator> values(alloc);
+        std::vector<size_t> hashes;
+        for (const auto &row : table)
+        {
+            for (const auto &probe_set : row)
+            {
+                for (const auto &node : probe_set)
+                {
+                    values.push_back(node.value);
+                    hashes.push_back(node.hash()); // Reuses the stored hash with StoreHash
+                }
+            }
+        }
+
+        for (auto &lock : locks[0])
+        {
+            lock.unlock();
+        }
+        return FrozenCuckooSet<T, Hash, KeyEqual, Allocator>(std::move(values), hashes, alloc);
+    }
+
+    // Add a list of values, moving each one into the set instead of copying it
+    // Values that were already present are left in list; the others are moved-from
+    int populate(std::vector<T> &&list)
+    {
+        reserve(size() + list.size());
+        int added = 0;
+        for (T &value : list)
+        {
+            if (add(std::move(value)))
+                added++;
+        }
+        return added;
+    }
 };
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <vector>      // For std::vector (buckets, locks and timestamps)
+#include <functional>  // For std::hash and std::equal_to
+#include <mutex>       // For std::mutex (segment locks)
+#include <atomic>      // For the atomic buckets read by lock-free contains
+#include <memory>      // For std::unique_ptr (retired tables)
+#include <cstdint>     // For std::uint32_t and std::uint64_t
+#include <type_traits> // For std::is_trivially_copyable
+
+#include "cuckoo-hash.h"     // For transparent lookup support
+#include "cuckoo-parallel.h" // For runParallel (the threaded populate)
+
+// This class implements a thread-safe hopscotch hash set (Herlihy, Shavit and Tzafrir), for comparison with the
+// concurrent cuckoo set. It is a single open-addressed table where every value sits within NEIGHBORHOOD buckets
+// of its home bucket, and each bucket keeps a bitmap (hop info) of which of the next NEIGHBORHOOD buckets hold
+// values that belong to it. A lookup reads the home bucket's bitmap and only the buckets it points to, usually in
+// one or two cache lines.
+
+// add takes an empty bucket up to ADD_RANGE buckets after the home bucket. If it is too far, values in between are
+// moved towards it ("hopped") until the empty bucket is inside the neighborhood. When that fails, the table doubles.
+// The table is split into SEGMENTS contiguous segments, each with a lock and a timestamp. add and remove lock the
+// segments they touch in increasing order; the table has ADD_RANGE extra buckets at the end instead of wrapping
+// around, so every operation's range is increasing and no two operations can deadlock.
+
+// contains takes no lock: it reads the segment timestamp, scans the neighborhood, and if the key was not found,
+// retries when the timestamp changed (a value of the segment was moved meanwhile) or the table was replaced.
+// Old tables are kept until the set is destroyed, as readers may still be scanning them; each resize doubles the
+// table, so together they take less memory than the current one.
+
+// Values are stored in place in atomic buckets, so T must be trivially copyable (e.g. int); the set is meant for
+// the benchmark's integer keys. Hash and KeyEqual work as in the other sets (transparent lookups included).
+template <class T, class Hash = std::hash<T>, class KeyEqual = std::equal_to<T>>
+class HopscotchConcurrentSet
+{
+    static_assert(std::is_trivially_copyable<T>::value, "HopscotchConcurrentSet stores values in atomic buckets");
+
+private:
+    static constexpr int NEIGHBORHOOD = 32;  // Buckets a value may be away from its home bucket (bits of the hop info)
+    static constexpr int ADD_RANGE = 512;    // Buckets add searches for an empty one before it resizes
+    static constexpr int SEGMENTS = 256;     // Segment locks (and timestamps)
+    static constexpr int READ_RETRIES = 8;   // Lock-free attempts of contains before it locks the segment
+    static constexpr double RESERVE_LOAD = 0.75; // Fraction of the buckets reserve() plans to fill
+
+    // One bucket: its hop info, its value, and whether the value is in use (written and read under locks only)
+    struct Bucket
+    {
+        std::atomic<std::uint32_t> hopInfo{0}; // Bit k: bucket b + k holds a value whose home is b
+        std::atomic<T> value{};
+        bool used = false;
+    };
+
+    // One table; it is never resized in place, a resize builds a new one
+    struct Table
+    {
+        size_t capacity;                                 // Home buckets (the first capacity buckets)
+        size_t segmentSize;                              // Buckets per segment
+        std::vector<Bucket> buckets;                     // capacity + ADD_RANGE buckets, so nothing wraps around
+        std::vector<std::atomic<std::uint32_t>> timestamps; // Bumped whenever a value of the segment is moved
+
+        explicit Table(size_t homeBuckets)
+            : capacity(homeBuckets),
+              segmentSize((homeBuckets + ADD_RANGE + SEGMENTS - 1) / SEGMENTS),
+              buckets(homeBuckets + ADD_RANGE),
+              timestamps(SEGMENTS)
+        {
+        }
+
+        // Home bucket of a key's Hash value (splitmix64 finalizer, then the high bits scaled to capacity)
+        size_t homeOf(size_t keyHash) const
+        {
+            std::uint64_t x = keyHash;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return static_cast<size_t>(((unsigned __int128)x * capacity) >> 64);
+        }
+
+        int segmentOf(size_t bucket) const
+        {
+            return static_cast<int>(bucket / segmentSize);
+        }
+    };
+
+    std::atomic<Table *> current;                 // The table in use, read by contains without locks
+    std::vector<std::unique_ptr<Table>> tables;   // Every table built so far; the last one is current
+    std::vector<std::mutex> locks;                // One lock per segment of the current table
+    std::atomic<int> count{0};                    // Number of values in the set
+
+    // Segments locked by one operation: first .. last, always taken in increasing order
+    struct SegmentGuard
+    {
+        std::vector<std::mutex> &locks;
+        int first = -1, last = -1;
+
+        explicit SegmentGuard(std::vector<std::mutex> &locks) : locks(locks) {}
+
+        // Lock every segment up to s that is not locked yet
+        void extendTo(int s)
+        {
+            if (first < 0)
+            {
+                locks[s].lock();
+                first = last = s;
+            }
+            while (last < s)
+                locks[++last].lock();
+        }
+
+        ~SegmentGuard()
+        {
+            for (int s = first; s >= 0 && s <= last; ++s)
+                locks[s].unlock();
+        }
+    };
+
+    // Lock the home segment of keyHash in the current table; returns that table, or null if a resize replaced it
+    // before the lock was taken (the caller then starts over)
+    Table *lockHome(SegmentGuard &guard, size_t keyHash, size_t &home)
+    {
+        Table *t = current.load(std::memory_order_acquire);
+        home = t->homeOf(keyHash);
+        guard.extendTo(t->segmentOf(home));
+        return current.load(std::memory_order_acquire) == t ? t : nullptr;
+    }
+
+    // The bucket holding key among home's neighborhood, or -1; hop info is read once, so this may run without locks
+    template <typename K>
+    static long findIn(const Table &t, size_t home, const K &key)
+    {
+        std::uint32_t hop = t.buckets[home].hopInfo.load(std::memory_order_acquire);
+        while (hop != 0)
+        {
+            int k = __builtin_ctz(hop);
+            if (KeyEqual{}(t.buckets[home + k].value.load(std::memory_order_relaxed), key))
+                return static_cast<long>(home + k);
+            hop &= hop - 1;
+        }
+        return -1;
+    }
+
+    // Move an empty bucket closer to home: find a value whose home lies before free and within reach of it, move it
+    // into free, and return the bucket it left (or 0 when no value can move; free is never 0 here). The caller holds
+    // the segments of every bucket from home to free
+    static size_t hopCloser(Table &t, size_t free)
+    {
+        for (size_t from = free - (NEIGHBORHOOD - 1); from < free; ++from)
+        {
+            std::uint32_t hop = t.buckets[from].hopInfo.load(std::memory_order_relaxed);
+            if (hop == 0)
+                continue;
+            size_t moved = from + __builtin_ctz(hop);
+            if (moved >= free)
+                continue;
+
+            // Copy the value before publishing its new bit, then bump the timestamp before the old bucket can be
+            // reused, so a reader that missed both copies sees the change and retries
+            t.buckets[free].value.store(t.buckets[moved].value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            t.buckets[free].used = true;
+            t.buckets[from].hopInfo.fetch_or(std::uint32_t(1) << (free - from), std::memory_order_release);
+            t.timestamps[t.segmentOf(from)].fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            t.buckets[from].hopInfo.fetch_and(~(std::uint32_t(1) << (moved - from)), std::memory_order_relaxed);
+            t.buckets[moved].used = false;
+            return moved;
+        }
+        return 0;
+    }
+
+    // Place value (not in the table) into t without taking any lock; only used while building a new table.
+    // Returns false if it does not fit
+    static bool placeUnlocked(Table &t, const T &value)
+    {
+        size_t home = t.homeOf(Hash{}(value));
+        size_t free = home;
+        while (free < home + ADD_RANGE && t.buckets[free].used)
+            ++free;
+        if (free == home + ADD_RANGE)
+            return false;
+        while (free - home >= NEIGHBORHOOD)
+        {
+            free = hopCloser(t, free);
+            if (free == 0)
+                return false;
+        }
+        t.buckets[free].value.store(value, std::memory_order_relaxed);
+        t.buckets[free].used = true;
+        t.buckets[home].hopInfo.fetch_or(std::uint32_t(1) << (free - home), std::memory_order_relaxed);
+        return true;
+    }
+
+    // Replace the table seen by a failed add with one of at least newCapacity home buckets (doubling until every
+    // value fits). Takes every segment lock, so no add or remove runs meanwhile; contains keeps reading the old table
+    void resize(Table *seen, size_t newCapacity)
+    {
+        SegmentGuard guard(locks);
+        guard.extendTo(0);
+        guard.extendTo(SEGMENTS - 1);
+        if (current.load(std::memory_order_relaxed) != seen) // Another thread resized first
+            return;
+
+        for (bool placed = false; !placed; newCapacity *= 2)
+        {
+            std::unique_ptr<Table> next(new Table(newCapacity));
+            placed = true;
+            for (Bucket &bucket : seen->buckets)
+                if (bucket.used && !placeUnlocked(*next, bucket.value.load(std::memory_order_relaxed)))
+                {
+                    placed = false;
+                    break;
+                }
+            if (placed)
+            {
+                current.store(next.get(), std::memory_order_release);
+                tables.push_back(std::move(next));
+            }
+        }
+    }
+
+    // Shared body of the add overloads
+    bool insert(const T &value, size_t keyHash)
+    {
+        for (;;)
+        {
+            Table *full; // The table the value did not fit in
+            {
+                SegmentGuard guard(locks);
+                size_t home;
+                Table *t = lockHome(guard, keyHash, home);
+                if (t == nullptr)
+                    continue;
+                if (findIn(*t, home, value) >= 0)
+                    return false;
+
+                // Find the first empty bucket, locking the segments on the way
+                size_t free = home;
+                for (; free < home + ADD_RANGE; ++free)
+                {
+                    guard.extendTo(t->segmentOf(free));
+                    if (!t->buckets[free].used)
+                        break;
+                }
+                // Hop it back into the neighborhood
+                while (free < home + ADD_RANGE && free - home >= NEIGHBORHOOD)
+                {
+                    free = hopCloser(*t, free);
+                    if (free == 0)
+                        free = home + ADD_RANGE;
+                }
+
+                if (free < home + ADD_RANGE)
+                {
+                    t->buckets[free].value.store(value, std::memory_order_relaxed);
+                    t->buckets[free].used = true;
+                    t->buckets[home].hopInfo.fetch_or(std::uint32_t(1) << (free - home), std::memory_order_release);
+                    count++;
+                    return true;
+                }
+                full = t;
+            } // The segments are released before resizing, which locks all of them
+            resize(full, 2 * full->capacity);
+        }
+    }
+
+    // Remove the value equal to key if it is present
+    template <typename K>
+    bool removeKey(const K &key)
+    {
+        size_t keyHash = Hash{}(key);
+        for (;;)
+        {
+            SegmentGuard guard(locks);
+            size_t home;
+            Table *t = lockHome(guard, keyHash, home);
+            if (t == nullptr)
+                continue;
+            long at = findIn(*t, home, key);
+            if (at < 0)
+                return false;
+            guard.extendTo(t->segmentOf(at)); // The bucket may lie in the next segment
+            t->buckets[home].hopInfo.fetch_and(~(std::uint32_t(1) << (at - home)), std::memory_order_release);
+            t->buckets[at].used = false;
+            count--;
+            return true;
+        }
+    }
+
+    // Check whether a value equal to key is present, without locks unless the segment keeps changing
+    template <typename K>
+    bool containsKey(const K &key)
+    {
+        size_t keyHash = Hash{}(key);
+        for (int attempt = 0; attempt < READ_RETRIES; ++attempt)
+        {
+            Table *t = current.load(std::memory_order_acquire);
+            size_t home = t->homeOf(keyHash);
+            std::atomic<std::uint32_t> &timestamp = t->timestamps[t->segmentOf(home)];
+            std::uint32_t before = timestamp.load(std::memory_order_acquire);
+            if (findIn(*t, home, key) >= 0)
+                return true;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (timestamp.load(std::memory_order_relaxed) == before && current.load(std::memory_order_relaxed) == t)
+                return false;
+        }
+        for (;;) // Values keep moving under us: look again with the home segment locked
+        {
+            SegmentGuard guard(locks);
+            size_t home;
+            if (Table *t = lockHome(guard, keyHash, home))
+                return findIn(*t, home, key) >= 0;
+        }
+    }
+
+public:
+    // Constructor with the initial number of home buckets
+    HopscotchConcurrentSet(int initial_capacity)
+        : locks(SEGMENTS)
+    {
+        tables.emplace_back(new Table(initial_capacity > 0 ? initial_capacity : 1));
+        current.store(tables.back().get(), std::memory_order_release);
+    }
+
+    HopscotchConcurrentSet(const HopscotchConcurrentSet &) = delete;
+    HopscotchConcurrentSet &operator=(const HopscotchConcurrentSet &) = delete;
+
+    // Add a value (copied into its bucket)
+    bool add(const T &val)
+    {
+        return insert(val, Hash{}(val));
+    }
+
+    // Remove a value if it is present
+    bool remove(const T &val)
+    {
+        return removeKey(val);
+    }
+
+    // Remove the value equal to key (only with a transparent Hash and KeyEqual)
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool remove(const K &key)
+    {
+        return removeKey(key);
+    }
+
+    // Check if a value is present in the set (lock-free in the common case)
+    bool contains(const T &val)
+    {
+        return containsKey(val);
+    }
+
+    // Check if a value equal to key is present (only with a transparent Hash and KeyEqual)
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool contains(const K &key)
+    {
+        return containsKey(key);
+    }
+
+    // Number of values in the set
+    int size() const
+    {
+        return count.load();
+    }
+
+    // Fraction of the current table's home buckets in use
+    double load_factor() const
+    {
+        return static_cast<double>(size()) / current.load(std::memory_order_acquire)->capacity;
+    }
+
+    // Presize the table for n values, so adding them does not have to resize on the way
+    void reserve(size_t n)
+    {
+        Table *t = current.load(std::memory_order_acquire);
+        size_t needed = static_cast<size_t>(n / RESERVE_LOAD) + 1;
+        if (needed > t->capacity)
+            resize(t, needed);
+    }
+
+    // Add a list of values; the table is presized for the whole list first
+    int populate(const std::vector<T> &list)
+    {
+        reserve(size() + list.size());
+        int added = 0;
+        for (const T &value : list)
+        {
+            if (add(value))
+                added++;
+        }
+        return added;
+    }
+
+    // Add a list of values using the given number of threads, each adding its share with the locking add
+    int populate(const std::vector<T> &list, int threads)
+    {
+        if (threads <= 1)
+            return populate(list);
+        reserve(size() + list.size());
+        std::atomic<int> added{0};
+        runParallel(threads, [&](int t)
+                    {
+            size_t begin = list.size() * t / threads;
+            size_t end = list.size() * (t + 1) / threads;
+            for (size_t index = begin; index < end; ++index)
+                if (add(list[index]))
+                    added++; });
+        return added.load();
+    }
+};
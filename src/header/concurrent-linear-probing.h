@@ -0,0 +1,355 @@
+#pragma once
+
+#include <vector>      // For std::vector (populate input)
+#include <functional>  // For std::hash
+#include <atomic>      // For the atomic slots, counters and table pointers
+#include <memory>      // For std::unique_ptr (the slot arrays)
+#include <cstdint>     // For std::uint32_t and std::uint64_t
+#include <type_traits> // For std::is_integral
+
+#include "cuckoo-parallel.h"   // For runParallel (the threaded populate)
+#include "epoch-reclamation.h" // For freeing replaced tables safely
+
+// This class implements a lock-free linear-probing hash set of integers, as the simplest lock-free design to compare
+// the concurrent cuckoo set with. No operation ever takes a lock.
+
+// Each slot is one 64-bit atomic word holding a key and its state (empty, present or deleted). add claims the first
+// empty slot of the key's probe sequence with a CAS, unless it meets the key first; a key never leaves the slot it
+// was claimed in, so remove only turns the slot into a tombstone with a CAS, and a later add of the same key revives
+// it. contains reads the probe sequence without writing anything.
+
+// Tombstones are only cleared by a migration to a new table, which starts once MAX_FILL of the slots are claimed.
+// The new table is twice as big if the live values need it, otherwise the same size. Every thread that meets the
+// migration helps it: slots are frozen one by one (a frozen slot can no longer change), the present keys copied to
+// the new table, and the first thread to see every slot copied makes the new table current. Until a slot is frozen
+// the old table still answers for it, so operations that do not meet a frozen slot simply finish in the old table.
+
+// Old tables are freed with epoch-based reclamation (see epoch-reclamation.h): every operation holds an epoch guard,
+// and a replaced table is only freed once no operation that might still read it is left.
+
+// Keys are stored in 32 bits, so T must be an integral type of at most 4 bytes (e.g. int).
+template <class T, class Hash = std::hash<T>>
+class LockFreeLinearSet
+{
+    static_assert(std::is_integral<T>::value && sizeof(T) <= 4, "LockFreeLinearSet stores keys in 32 bits");
+
+private:
+    using Word = std::uint64_t;
+
+    static constexpr Word PRESENT = Word(1) << 32;  // The slot holds a key of the set
+    static constexpr Word DELETED = Word(2) << 32;  // The slot holds a removed key (tombstone)
+    static constexpr Word FROZEN = Word(1) << 34;   // A migration froze the slot; it can no longer change
+    static constexpr Word COPIED = Word(1) << 35;   // A frozen slot whose key is already in the new table
+    static constexpr Word STATE = PRESENT | DELETED;
+
+    static constexpr double MAX_FILL = 0.75;   // Fraction of claimed slots (present or deleted) that starts a migration
+    static constexpr double NEW_LOAD = 0.375;  // Largest fraction of live values a new table starts with
+    static constexpr size_t CHUNK = 1024;      // Slots a migrating thread claims at a time
+
+    // One table; a migration builds a new one and links it as next
+    struct Table
+    {
+        size_t mask;                              // Slots - 1 (the number of slots is a power of two)
+        std::unique_ptr<std::atomic<Word>[]> slots;
+        std::atomic<size_t> claimed{0};           // Slots that are not empty
+        std::atomic<Table *> next{nullptr};       // The table this one migrates to (null until a migration starts)
+        std::atomic<size_t> nextChunk{0};         // First chunk no migrating thread has claimed
+        std::atomic<size_t> chunksDone{0};        // Chunks fully copied
+
+        explicit Table(size_t size)
+            : mask(size - 1), slots(new std::atomic<Word>[size])
+        {
+            for (size_t i = 0; i < size; ++i)
+                slots[i].store(0, std::memory_order_relaxed);
+        }
+
+        size_t size() const { return mask + 1; }
+
+        size_t chunks() const { return (size() + CHUNK - 1) / CHUNK; }
+    };
+
+    std::atomic<Table *> current;                     // The table operations start from
+    std::atomic<int> count{0};                        // Number of values in the set
+    EpochDomain epochs;                               // Frees replaced tables once no operation can read them
+
+    static Word keyBits(T key)
+    {
+        return static_cast<std::uint32_t>(key);
+    }
+
+    // Home slot of a key (splitmix64 finalizer of its Hash value)
+    static size_t homeOf(const Table &t, T key)
+    {
+        std::uint64_t x = Hash{}(key);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<size_t>(x ^ (x >> 31)) & t.mask;
+    }
+
+    // The smallest power of two of at least n (and at least 16)
+    static size_t ceilPow2(size_t n)
+    {
+        size_t p = 16;
+        while (p < n)
+            p *= 2;
+        return p;
+    }
+
+    // The first slot of key's probe sequence that is empty or holds key (in any state), and its word in w.
+    // Returns t.size() if the probe went round the whole table
+    static size_t probe(const Table &t, T key, Word &w)
+    {
+        size_t i = homeOf(t, key);
+        for (size_t n = 0; n <= t.mask; ++n, i = (i + 1) & t.mask)
+        {
+            w = t.slots[i].load(std::memory_order_acquire);
+            if ((w & STATE) == 0 || (w & 0xffffffffULL) == keyBits(key))
+                return i;
+        }
+        return t.size();
+    }
+
+    // Insert a key copied from the old table, unless the new table already has a slot for it (which also keeps a
+    // late copy from reviving a key removed from the new table meanwhile)
+    static void copyInto(Table &t, T key)
+    {
+        for (;;)
+        {
+            Word w;
+            size_t i = probe(t, key, w);
+            if ((w & STATE) != 0)
+                return;
+            if (t.slots[i].compare_exchange_strong(w, keyBits(key) | PRESENT))
+            {
+                t.claimed.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    // Freeze slot i of t and copy its key to next if it is present; safe to repeat, and by several threads at once
+    static void copySlot(Table &t, size_t i, Table &next)
+    {
+        Word w = t.slots[i].load(std::memory_order_acquire);
+        while (!(w & FROZEN) && !t.slots[i].compare_exchange_weak(w, w | FROZEN))
+            ;
+        w |= FROZEN;
+        if (w & COPIED)
+            return;
+        if ((w & STATE) == PRESENT)
+            copyInto(next, static_cast<T>(static_cast<std::uint32_t>(w)));
+        t.slots[i].fetch_or(COPIED, std::memory_order_release);
+    }
+
+    // Start migrating t to a new table of at least minSize slots (unless a migration already started)
+    void startMigration(Table *t, size_t minSize)
+    {
+        if (t->next.load() == nullptr)
+        {
+            size_t size = t->size() > minSize ? t->size() : minSize;
+            while (count.load(std::memory_order_relaxed) > NEW_LOAD * size)
+                size *= 2;
+            Table *fresh = new Table(ceilPow2(size));
+            Table *expected = nullptr;
+            if (!t->next.compare_exchange_strong(expected, fresh))
+                delete fresh; // Another thread started it first
+        }
+        helpMigrate(t);
+    }
+
+    // Help the migration out of t until every slot is copied, then make the new table current
+    void helpMigrate(Table *t)
+    {
+        Table *next = t->next.load();
+        size_t chunks = t->chunks();
+        for (size_t c = t->nextChunk.fetch_add(1); c < chunks; c = t->nextChunk.fetch_add(1))
+        {
+            size_t end = (c + 1) * CHUNK < t->size() ? (c + 1) * CHUNK : t->size();
+            for (size_t i = c * CHUNK; i < end; ++i)
+                copySlot(*t, i, *next);
+            t->chunksDone.fetch_add(1);
+        }
+        if (t->chunksDone.load() < chunks) // Other threads are still copying: finish their slots too
+            for (size_t i = 0; i < t->size(); ++i)
+                copySlot(*t, i, *next);
+
+        Table *expected = t;
+        if (current.compare_exchange_strong(expected, next))
+        {
+            epochs.retire(t);
+            epochs.reclaim(); // Tables are retired rarely: free the older ones right away if possible
+        }
+    }
+
+    bool insert(T key)
+    {
+        EpochDomain::Guard guard(epochs);
+        Table *t = current.load();
+        for (;;)
+        {
+            if (Table *next = t->next.load())
+            {
+                helpMigrate(t);
+                t = next;
+                continue;
+            }
+            Word w;
+            size_t i = probe(*t, key, w);
+            if (i == t->size() || (w & FROZEN))
+            {
+                startMigration(t, 0); // The table is full (or a migration froze the slot)
+                t = t->next.load();
+                continue;
+            }
+            if ((w & STATE) == PRESENT)
+                return false;
+            if ((w & STATE) == 0 && t->claimed.load(std::memory_order_relaxed) + 1 > MAX_FILL * t->size())
+            {
+                startMigration(t, 0);
+                t = t->next.load();
+                continue;
+            }
+            // Claim the empty slot, or revive the key's tombstone; on failure the slot changed, so look again
+            if (t->slots[i].compare_exchange_strong(w, keyBits(key) | PRESENT))
+            {
+                if ((w & STATE) == 0)
+                    t->claimed.fetch_add(1, std::memory_order_relaxed);
+                count++;
+                return true;
+            }
+        }
+    }
+
+    bool removeKey(T key)
+    {
+        EpochDomain::Guard guard(epochs);
+        Table *t = current.load();
+        for (;;)
+        {
+            Word w;
+            size_t i = probe(*t, key, w);
+            if (i < t->size() && (w & FROZEN))
+            {
+                helpMigrate(t);
+                t = t->next.load();
+                continue;
+            }
+            if (i == t->size() || (w & STATE) != PRESENT)
+                return false;
+            if (t->slots[i].compare_exchange_strong(w, keyBits(key) | DELETED))
+            {
+                count--;
+                return true;
+            }
+        }
+    }
+
+    bool containsKey(T key)
+    {
+        EpochDomain::Guard guard(epochs);
+        Table *t = current.load();
+        for (;;)
+        {
+            Word w;
+            size_t i = probe(*t, key, w);
+            if (i < t->size() && (w & FROZEN))
+            {
+                // The key may have been copied and changed in the new table since: make sure it was copied, then
+                // ask the new table
+                Table *next = t->next.load();
+                copySlot(*t, i, *next);
+                t = next;
+                continue;
+            }
+            return i < t->size() && (w & STATE) == PRESENT;
+        }
+    }
+
+public:
+    // Constructor with the initial number of slots (rounded up to a power of two)
+    LockFreeLinearSet(int initial_capacity)
+    {
+        current.store(new Table(ceilPow2(initial_capacity > 0 ? initial_capacity : 1)));
+    }
+
+    LockFreeLinearSet(const LockFreeLinearSet &) = delete;
+    LockFreeLinearSet &operator=(const LockFreeLinearSet &) = delete;
+
+    // Free the current table (epochs frees the retired ones); no operation may be running
+    ~LockFreeLinearSet()
+    {
+        Table *t = current.load();
+        delete t->next.load();
+        delete t;
+    }
+
+    // Add a value to the set
+    bool add(const T &val)
+    {
+        return insert(val);
+    }
+
+    // Remove a value if it is present
+    bool remove(const T &val)
+    {
+        return removeKey(val);
+    }
+
+    // Check if a value is present in the set
+    bool contains(const T &val)
+    {
+        return containsKey(val);
+    }
+
+    // Number of values in the set
+    int size() const
+    {
+        return count.load();
+    }
+
+    // Slots of the current table
+    size_t slot_count() const
+    {
+        return current.load()->size();
+    }
+
+    // Presize the table for n values, so adding them does not have to migrate on the way
+    void reserve(size_t n)
+    {
+        EpochDomain::Guard guard(epochs);
+        Table *t = current.load();
+        size_t needed = static_cast<size_t>(n / NEW_LOAD) + 1;
+        if (needed > t->size())
+            startMigration(t, needed);
+    }
+
+    // Add a list of values; the table is presized for the whole list first
+    int populate(const std::vector<T> &list)
+    {
+        reserve(size() + list.size());
+        int added = 0;
+        for (const T &value : list)
+        {
+            if (add(value))
+                added++;
+        }
+        return added;
+    }
+
+    // Add a list of values using the given number of threads, each adding its share with the lock-free add
+    int populate(const std::vector<T> &list, int threads)
+    {
+        if (threads <= 1)
+            return populate(list);
+        reserve(size() + list.size());
+        std::atomic<int> added{0};
+        runParallel(threads, [&](int t)
+                    {
+            size_t begin = list.size() * t / threads;
+            size_t end = list.size() * (t + 1) / threads;
+            for (size_t index = begin; index < end; ++index)
+                if (add(list[index]))
+                    added++; });
+        return added.load();
+    }
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>  // For std::vector (the blocks)
+#include <atomic>  // For std::atomic (bits shared with lock-free readers)
+#include <cstdint> // For std::uint64_t and std::uint32_t
+
+// Blocked Bloom filter used as an optional prefilter in front of the sets' contains (see enable_prefilter).
+//
+// Most lookups in our workloads miss, and a miss probes both tables (and in CuckooConcurrentSet takes two locks).
+// The prefilter answers "definitely absent" for most of them from a single cache line: the filter is an array of
+// 64-byte blocks, a key picks one block from its hash, and sets one bit in each of the block's eight 64-bit words.
+// With the default 10 bits per key that gives roughly a 1% false-positive rate at the planned load.
+//
+// Bloom filters cannot forget a key, so removed keys keep their bits until the filter is rebuilt, which the sets
+// do whenever their tables are rebuilt. The bits are atomic words, so lookups may run alongside insert.
+class BlockedBloomFilter
+{
+private:
+    using Word = std::uint64_t;
+
+    static constexpr int BLOCK_WORDS = 8;                         // Words per block, one bit set in each (64 bytes).
+    static constexpr int BITS_PER_BLOCK = BLOCK_WORDS * 64;
+
+    // One cache line of the filter.
+    struct alignas(64) Block
+    {
+        std::atomic<Word> words[BLOCK_WORDS];
+    };
+
+    std::vector<Block> blocks;
+
+    // Mix a key's Hash value (splitmix64 finalizer), since std::hash of an int is the int itself.
+    static Word mix(size_t keyHash)
+    {
+        Word x = keyHash;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // The block of a mixed hash, from its high 32 bits.
+    size_t blockOf(Word h) const
+    {
+        return ((h >> 32) * blocks.size()) >> 32;
+    }
+
+    // The bit a mixed hash sets in word w of its block, from its low 32 bits and a per-word odd multiplier.
+    static Word bitOf(Word h, int w)
+    {
+        static constexpr std::uint32_t SALTS[BLOCK_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                             0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+        return Word(1) << ((static_cast<std::uint32_t>(h) * SALTS[w]) >> 26);
+    }
+
+public:
+    // A filter sized for keys keys at bitsPerKey bits each (at least one block).
+    BlockedBloomFilter(size_t keys, int bitsPerKey)
+        : blocks(keys * bitsPerKey / BITS_PER_BLOCK + 1)
+    {
+        for (Block &block : blocks)
+            for (auto &word : block.words)
+                word.store(0, std::memory_order_relaxed);
+    }
+
+    // Record a key (by its Hash value). Safe to call while other threads call insert or mayContain.
+    void insert(size_t keyHash)
+    {
+        Word h = mix(keyHash);
+        Block &block = blocks[blockOf(h)];
+        for (int w = 0; w < BLOCK_WORDS; ++w)
+            block.words[w].fetch_or(bitOf(h, w), std::memory_order_release);
+    }
+
+    // Record a key when the caller is the only thread touching the filter (no atomic read-modify-write).
+    void insertExclusive(size_t keyHash)
+    {
+        Word h = mix(keyHash);
+        Block &block = blocks[blockOf(h)];
+        for (int w = 0; w < BLOCK_WORDS; ++w)
+            block.words[w].store(block.words[w].load(std::memory_order_relaxed) | bitOf(h, w), std::memory_order_relaxed);
+    }
+
+    // False if the key (by its Hash value) was never inserted; true if it probably was.
+    bool mayContain(size_t keyHash) const
+    {
+        Word h = mix(keyHash);
+        const Block &block = blocks[blockOf(h)];
+        Word missing = 0;
+        for (int w = 0; w < BLOCK_WORDS; ++w)
+        {
+            Word bit = bitOf(h, w);
+            missing |= bit & ~block.words[w].load(std::memory_order_acquire);
+        }
+        return missing == 0;
+    }
+
+    // Bytes held by the blocks.
+    size_t memory_usage() const
+    {
+        return blocks.size() * sizeof(Block);
+    }
+};
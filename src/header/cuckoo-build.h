@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>  // For std::vector (the cuckoo graph and the result)
+#include <utility> // For std::pair
+
+// Stable counting sort of items by bucketOf(item), a value in 0 .. buckets-1.
+// The build sorts keys by their first bucket: equal keys become neighbours, and the solver then walks the
+// slots of table 0 and the keys in nearly the same order, which keeps most of its memory accesses sequential.
+template <typename Item, typename BucketFn>
+void sortByBucket(std::vector<Item> &items, int buckets, BucketFn bucketOf)
+{
+    std::vector<int> start(buckets + 1, 0);
+    for (const Item &item : items)
+        start[bucketOf(item) + 1]++;
+    for (int b = 0; b < buckets; ++b)
+        start[b + 1] += start[b];
+    std::vector<Item> sorted(items.size());
+    for (const Item &item : items)
+        sorted[start[bucketOf(item)]++] = item;
+    items.swap(sorted);
+}
+
+// Offline placement solver for building a two-table cuckoo set from a known list of keys in one batch.
+//
+// Every key is an edge of the cuckoo graph between its two candidate slots: buckets[k].first in table 0 and
+// buckets[k].second in table 1. A placement gives each edge one of its two endpoints, with no slot used twice.
+// One exists exactly when no connected component of the graph has more edges than nodes (at most one cycle).
+//
+// The solver peels the graph: a slot with a single remaining key must take that key, which may leave another
+// slot with a single key, and so on. This places every key of the tree-shaped components. What is left are
+// cycles. The solver breaks each one by giving any of its keys to a free endpoint, and peeling then goes
+// around the rest of the cycle. Each slot keeps its degree and the XOR of its remaining key indexes, so the
+// last key of a slot is found without adjacency lists, and the whole solve runs in linear time.
+//
+// The result lists, for every slot, the index of the key it holds or -1. Slots are numbered 0 .. capacity-1 in
+// table 0 and capacity .. 2*capacity-1 in table 1, so the caller writes both tables in one pass over it. The
+// result is empty if some component has two cycles; the caller then retries with new hash functions, or more slots.
+inline std::vector<int> solvePlacement(const std::vector<std::pair<int, int>> &buckets, int capacity)
+{
+    // State of one slot, packed together so that updating it touches a single cache line
+    struct Slot
+    {
+        int degree = 0; // Keys not yet placed that can go into the slot (-1 once the slot holds a key)
+        int keyXor = 0; // XOR of the indexes of those keys; once the slot holds a key, that key's index
+    };
+
+    const int keys = static_cast<int>(buckets.size());
+    std::vector<Slot> slots(2 * capacity);
+    std::vector<bool> placed(keys, false); // Whether each key has a slot (a bitmap, small enough to stay in cache)
+    std::vector<int> leaves;               // Slots that have a single key left (a work queue)
+
+    for (int k = 0; k < keys; ++k)
+    {
+        Slot &a = slots[buckets[k].first];
+        Slot &b = slots[capacity + buckets[k].second];
+        a.degree++;
+        a.keyXor ^= k;
+        b.degree++;
+        b.keyXor ^= k;
+    }
+
+    // Give key k to slot, remove it from its other endpoint, and queue that one if it became a leaf
+    auto assign = [&](int k, int slot)
+    {
+        placed[k] = true;
+        slots[slot].degree = -1;
+        slots[slot].keyXor = k;
+        int other = (slot == buckets[k].first) ? capacity + buckets[k].second : buckets[k].first;
+        Slot &end = slots[other];
+        if (end.degree > 0)
+        {
+            end.degree--;
+            end.keyXor ^= k;
+            if (end.degree == 1)
+                leaves.push_back(other);
+        }
+    };
+
+    // Place the last key of every leaf until no free slot has exactly one key left
+    auto peel = [&]()
+    {
+        // Leaves are taken in the order they were found (not last-in, first-out), so consecutive steps touch
+        // unrelated slots and their cache misses overlap instead of forming one long dependent chain
+        for (size_t next = 0; next < leaves.size(); ++next)
+        {
+            int slot = leaves[next];
+            if (slots[slot].degree == 1)
+                assign(slots[slot].keyXor, slot);
+        }
+        leaves.clear();
+    };
+
+    for (int slot = 0; slot < 2 * capacity; ++slot)
+        if (slots[slot].degree == 1)
+            leaves.push_back(slot);
+    peel();
+
+    // Only cycles (and components with several cycles) are left: break each one and peel around it
+    for (int k = 0; k < keys; ++k)
+    {
+        if (placed[k])
+            continue;
+        int a = buckets[k].first;
+        int b = capacity + buckets[k].second;
+        if (slots[a].degree < 0 && slots[b].degree < 0)
+            return std::vector<int>(); // Both endpoints taken: this component has more keys than slots
+        assign(k, slots[a].degree < 0 ? b : a);
+        peel();
+    }
+
+    std::vector<int> holder(2 * capacity);
+    for (int slot = 0; slot < 2 * capacity; ++slot)
+        holder[slot] = slots[slot].degree < 0 ? slots[slot].keyXor : -1;
+    return holder;
+}
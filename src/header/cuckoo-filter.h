@@ -0,0 +1,280 @@
+#pragma once
+
+#include <vector>     // For std::vector (the packed bucket array)
+#include <functional> // For std::hash
+#include <cstdint>    // For std::uint64_t
+#include <cstring>    // For std::memcpy (unaligned bucket loads and stores)
+#include <cstdlib>    // For std::rand (choosing which fingerprint to evict)
+#include <cmath>      // For std::log2 and std::ceil (fingerprint size from the false-positive rate)
+
+// This class implements a cuckoo filter: an approximate-membership structure that answers "might this key be in
+// the set?" with no false negatives and a configurable false-positive rate, in a fraction of the memory of
+// CuckooSequentialSet. Instead of the key it stores a short fingerprint of the key's hash (8 to 16 bits).
+//
+// Fingerprints live in buckets of SLOTS_PER_BUCKET slots, and every key has two candidate buckets, as every key of
+// the sets has two candidate tables. The second bucket is computed from the first one and the fingerprint alone
+// (partial-key cuckoo hashing): alt(i) = (h(fingerprint) - i) mod buckets, which is its own inverse, so a
+// fingerprint can be moved to its other bucket during displacement without knowing its key. That also lets the
+// bucket count be any number, not just a power of two, so the table is sized for the expected key count.
+//
+// Four-way buckets let the filter reach a load of about 95% before displacement fails. A lookup reads two
+// buckets, and with b fingerprints of f bits compared per bucket the false-positive rate is at most 2b / 2^f,
+// so f is chosen as the smallest size meeting the requested rate (12 bits for the default 0.3%, which costs
+// about 12.6 bits per key at 95% load). Buckets are packed bit by bit: bucket i starts at bit i * 4f, and is
+// read and written as one unaligned 64-bit word.
+//
+// remove() deletes one copy of a fingerprint, so only keys that were added may be removed. Adding the same key
+// twice stores it twice. When displacement gives up, the fingerprint displaced last is kept aside as a victim, so
+// the key being added and every key added before it are still stored. The filter is then full: later adds return
+// false until a remove makes room for the victim.
+// CuckooFilter is not thread-safe.
+template <typename T, typename Hash = std::hash<T>>
+class CuckooFilter
+{
+private:
+    using Word = std::uint64_t;
+
+    static constexpr int SLOTS_PER_BUCKET = 4;    // Fingerprints per bucket.
+    static constexpr int MIN_FINGERPRINT_BITS = 8; // Smallest fingerprint size.
+    static constexpr int MAX_FINGERPRINT_BITS = 16; // Largest fingerprint size (a bucket is then one 64-bit word).
+    static constexpr double MAX_LOAD = 0.95;        // Load the filter is sized for.
+    static constexpr int MAX_DISPLACEMENTS = 500;   // Evictions tried before the filter counts as full.
+
+    int fingerprintBits;           // Bits per fingerprint (8 .. 16).
+    int bucketBits;                // Bits per bucket (SLOTS_PER_BUCKET * fingerprintBits).
+    Word fingerprintMask;          // Selects one fingerprint.
+    size_t buckets;                // Number of buckets.
+    int count;                     // Number of fingerprints stored (including the victim).
+    std::vector<unsigned char> data; // The packed buckets, plus padding for the last 64-bit access.
+
+    // The fingerprint that did not fit when the filter became full, and one of its two buckets.
+    struct Victim
+    {
+        bool used = false;
+        Word fingerprint = 0;
+        size_t bucket = 0;
+    } victim;
+
+    // Hash a key once per operation; the bucket and the fingerprint are both taken from this value.
+    // The key's Hash value is mixed (splitmix64 finalizer), since std::hash of an int is the int itself.
+    static Word hashKey(const T &key)
+    {
+        Word x = Hash{}(key);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Fingerprint from the high bits of a key's hash (forced non-zero so that 0 still means an empty slot).
+    Word fingerprint(Word keyHash) const
+    {
+        Word tag = (keyHash >> (64 - fingerprintBits)) & fingerprintMask;
+        return tag ? tag : 1;
+    }
+
+    // First bucket from the low bits of a key's hash.
+    size_t bucketOf(Word keyHash) const
+    {
+        return static_cast<size_t>(keyHash % buckets);
+    }
+
+    // The other bucket of a fingerprint that sits in bucket i. alt(alt(i)) == i for every i.
+    size_t altBucket(size_t i, Word tag) const
+    {
+        size_t t = static_cast<size_t>((tag * 0x5bd1e995ULL) % buckets); // MurmurHash2 multiplier
+        return t >= i ? t - i : t + buckets - i;
+    }
+
+    // Mask of a whole bucket within its 64-bit word.
+    Word bucketMask() const
+    {
+        return bucketBits == 64 ? ~Word(0) : (Word(1) << bucketBits) - 1;
+    }
+
+    // Read bucket i: its fingerprints packed into the low bucketBits bits, slot 0 lowest.
+    Word readBucket(size_t i) const
+    {
+        size_t bit = i * bucketBits;
+        Word word;
+        std::memcpy(&word, data.data() + bit / 8, sizeof(Word));
+        return (word >> (bit % 8)) & bucketMask();
+    }
+
+    // Write bucket i, leaving the neighbouring buckets that share its bytes untouched.
+    void writeBucket(size_t i, Word bucket)
+    {
+        size_t bit = i * bucketBits;
+        Word word;
+        std::memcpy(&word, data.data() + bit / 8, sizeof(Word));
+        word = (word & ~(bucketMask() << (bit % 8))) | (bucket << (bit % 8));
+        std::memcpy(data.data() + bit / 8, &word, sizeof(Word));
+    }
+
+    Word slotOf(Word bucket, int slot) const
+    {
+        return (bucket >> (slot * fingerprintBits)) & fingerprintMask;
+    }
+
+    Word withSlot(Word bucket, int slot, Word tag) const
+    {
+        int shift = slot * fingerprintBits;
+        return (bucket & ~(fingerprintMask << shift)) | (tag << shift);
+    }
+
+    // Whether bucket i holds tag.
+    bool bucketHas(size_t i, Word tag) const
+    {
+        Word bucket = readBucket(i);
+        for (int slot = 0; slot < SLOTS_PER_BUCKET; ++slot)
+            if (slotOf(bucket, slot) == tag)
+                return true;
+        return false;
+    }
+
+    // Put tag into an empty slot of bucket i. Returns false if the bucket is full.
+    bool insertInto(size_t i, Word tag)
+    {
+        Word bucket = readBucket(i);
+        for (int slot = 0; slot < SLOTS_PER_BUCKET; ++slot)
+            if (slotOf(bucket, slot) == 0)
+            {
+                writeBucket(i, withSlot(bucket, slot, tag));
+                return true;
+            }
+        return false;
+    }
+
+    // Remove one copy of tag from bucket i. Returns false if it is not there.
+    bool removeFrom(size_t i, Word tag)
+    {
+        Word bucket = readBucket(i);
+        for (int slot = 0; slot < SLOTS_PER_BUCKET; ++slot)
+            if (slotOf(bucket, slot) == tag)
+            {
+                writeBucket(i, withSlot(bucket, slot, 0));
+                return true;
+            }
+        return false;
+    }
+
+    // Run the displacement loop for a fingerprint whose buckets are both full, starting from bucket i:
+    // evict a random fingerprint of the bucket, take its place, and move the evicted one to its other bucket.
+    // If it gives up, the fingerprint left in hand becomes the victim.
+    void displace(size_t i, Word tag)
+    {
+        for (int n = 0; n < MAX_DISPLACEMENTS; ++n)
+        {
+            int slot = std::rand() % SLOTS_PER_BUCKET;
+            Word bucket = readBucket(i);
+            Word evicted = slotOf(bucket, slot);
+            writeBucket(i, withSlot(bucket, slot, tag));
+            tag = evicted;
+            i = altBucket(i, tag);
+            if (insertInto(i, tag))
+                return;
+        }
+        victim.used = true; // Gave up; keep the homeless fingerprint so its key still tests positive.
+        victim.fingerprint = tag;
+        victim.bucket = i;
+    }
+
+    // Bits per fingerprint needed for a false-positive rate of at most rate.
+    static int bitsFor(double rate)
+    {
+        int bits = static_cast<int>(std::ceil(std::log2(2.0 * SLOTS_PER_BUCKET / rate)));
+        return bits < MIN_FINGERPRINT_BITS ? MIN_FINGERPRINT_BITS : bits > MAX_FINGERPRINT_BITS ? MAX_FINGERPRINT_BITS : bits;
+    }
+
+public:
+    // Constructor sizing the filter for capacity keys with a false-positive rate of about falsePositiveRate
+    // (clamped to what 8 to 16-bit fingerprints can give: from about 3% down to about 0.01%).
+    explicit CuckooFilter(size_t capacity, double falsePositiveRate = 0.003)
+        : fingerprintBits(bitsFor(falsePositiveRate)),
+          bucketBits(SLOTS_PER_BUCKET * fingerprintBits),
+          fingerprintMask((Word(1) << fingerprintBits) - 1),
+          buckets(static_cast<size_t>(capacity / (SLOTS_PER_BUCKET * MAX_LOAD)) + 1),
+          count(0),
+          data((buckets * bucketBits + 7) / 8 + sizeof(Word), 0) // Padding so the last bucket can be read as a word.
+    {
+    }
+
+    // Add a key. Returns false, storing nothing, if the filter is full (a victim is waiting for room). An add
+    // whose displacement fills the filter still stores its key and returns true.
+    bool add(const T &key)
+    {
+        if (victim.used)
+            return false;
+        Word keyHash = hashKey(key);
+        Word tag = fingerprint(keyHash);
+        size_t i1 = bucketOf(keyHash);
+        ++count;
+        if (!insertInto(i1, tag) && !insertInto(altBucket(i1, tag), tag))
+            displace(std::rand() % 2 ? i1 : altBucket(i1, tag), tag);
+        return true;
+    }
+
+    // Remove one copy of a key that was added before. Returns false if no matching fingerprint was found.
+    bool remove(const T &key)
+    {
+        Word keyHash = hashKey(key);
+        Word tag = fingerprint(keyHash);
+        size_t i1 = bucketOf(keyHash);
+        size_t i2 = altBucket(i1, tag);
+        if (removeFrom(i1, tag) || removeFrom(i2, tag))
+        {
+            --count;
+            if (victim.used && insertInto(victim.bucket, victim.fingerprint)) // Room for the victim again.
+                victim.used = false;
+            return true;
+        }
+        if (victim.used && victim.fingerprint == tag && (victim.bucket == i1 || victim.bucket == i2))
+        {
+            victim.used = false;
+            --count;
+            return true;
+        }
+        return false;
+    }
+
+    // Check if the key might be in the set: false means definitely not, true means probably.
+    bool contains(const T &key) const
+    {
+        Word keyHash = hashKey(key);
+        Word tag = fingerprint(keyHash);
+        size_t i1 = bucketOf(keyHash);
+        size_t i2 = altBucket(i1, tag);
+        return bucketHas(i1, tag) || bucketHas(i2, tag) ||
+               (victim.used && victim.fingerprint == tag && (victim.bucket == i1 || victim.bucket == i2));
+    }
+
+    // Count how many fingerprints are stored in the filter.
+    int size() const
+    {
+        return count;
+    }
+
+    // Bits per fingerprint, as chosen from the false-positive rate.
+    int fingerprint_bits() const
+    {
+        return fingerprintBits;
+    }
+
+    // Fraction of the slots in use.
+    double load_factor() const
+    {
+        return static_cast<double>(count) / (buckets * SLOTS_PER_BUCKET);
+    }
+
+    // Upper bound on the false-positive rate at the current load: 2 buckets of occupied slots, each matching a
+    // random fingerprint with probability 1 / (2^f - 1).
+    double false_positive_rate() const
+    {
+        return 2.0 * SLOTS_PER_BUCKET * load_factor() / static_cast<double>(fingerprintMask);
+    }
+
+    // Bytes held by the packed buckets.
+    size_t memory_usage() const
+    {
+        return data.size();
+    }
+};
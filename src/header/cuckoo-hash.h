@@ -0,0 +1,98 @@
+#pragma once
+
+#include <functional>  // For std::hash and std::equal_to
+#include <string>      // For std::string
+#include <string_view> // For std::string_view
+#include <type_traits> // For std::enable_if_t, std::void_t and std::bool_constant
+#include <utility>     // For std::forward and std::in_place_t
+
+// Hashing helpers shared by the cuckoo sets.
+//
+// The sets take a Hash and a KeyEqual template parameter, like std::unordered_set. When both of them
+// declare an is_transparent member type, contains and remove also accept any key type K that Hash and
+// KeyEqual understand, so a set of std::string can be queried with a std::string_view or a const char *
+// without building a temporary std::string. CuckooTransactionalSet is the exception: it compares keys
+// inside transactions, and these string helpers are not transaction-safe.
+
+// Transparent hash for string keys. std::hash<std::string_view> is guaranteed to give the same value as
+// std::hash<std::string> for the same characters, so stored strings and lookup views always agree.
+struct StringHash
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view key) const
+    {
+        return std::hash<std::string_view>{}(key);
+    }
+};
+
+// Transparent equality for string keys (std::equal_to<> would also work).
+using StringEqual = std::equal_to<>;
+
+// True if F declares the is_transparent member type.
+template <typename F, typename = void>
+struct IsTransparent : std::false_type
+{
+};
+
+template <typename F>
+struct IsTransparent<F, std::void_t<typename F::is_transparent>> : std::true_type
+{
+};
+
+// Enables a heterogeneous overload for key type K only when both the hash and the equality are transparent.
+// K is part of the result so the check stays dependent (and SFINAE-friendly) inside member templates.
+template <typename Hash, typename KeyEqual, typename K>
+using EnableIfTransparent = std::enable_if_t<IsTransparent<Hash>::value && IsTransparent<KeyEqual>::value, K>;
+
+// Whether the sets remember each value's hash by default: on for anything that is not a scalar
+// (strings, vectors, structs), where hashing and comparing are expensive; off for ints and pointers.
+template <typename T>
+struct StoreHashByDefault : std::bool_constant<!std::is_scalar<T>::value>
+{
+};
+
+// A stored value, optionally paired with its full Hash value.
+//
+// With StoreHash, the hash is computed once when the value enters the set. Probes compare it before
+// calling KeyEqual, so a miss on a long string key almost never reads the string, and resizing or
+// relocating reuses it instead of calling Hash again. Without StoreHash the hash is recomputed on demand.
+template <typename T, typename Hash, bool StoreHash>
+struct StoredValue;
+
+template <typename T, typename Hash>
+struct StoredValue<T, Hash, true>
+{
+    T value;          // The stored key
+    size_t hashValue; // Hash{}(value), computed once
+
+    // Build the value from args when its hash is already known
+    template <typename... Args>
+    explicit StoredValue(size_t hash, std::in_place_t, Args &&...args)
+        : value(std::forward<Args>(args)...), hashValue(hash) {}
+
+    // Build the value from args and hash it
+    template <typename... Args>
+    explicit StoredValue(std::in_place_t, Args &&...args)
+        : value(std::forward<Args>(args)...), hashValue(Hash{}(value)) {}
+
+    size_t hash() const { return hashValue; }
+    bool hashMatches(size_t hash) const { return hashValue == hash; }
+};
+
+template <typename T, typename Hash>
+struct StoredValue<T, Hash, false>
+{
+    T value; // The stored key
+
+    template <typename... Args>
+    explicit StoredValue(size_t, std::in_place_t, Args &&...args)
+        : value(std::forward<Args>(args)...) {}
+
+    template <typename... Args>
+    explicit StoredValue(std::in_place_t, Args &&...args)
+        : value(std::forward<Args>(args)...) {}
+
+    size_t hash() const { return Hash{}(value); }
+    bool hashMatches(size_t) const { return true; }
+};
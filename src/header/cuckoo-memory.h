@@ -0,0 +1,152 @@
+#pragma once
+
+#include <memory>      // For std::allocator and std::allocator_traits
+#include <new>         // For ::operator new, ::operator delete and std::bad_alloc
+#include <cstdint>     // For std::uintptr_t
+#include <type_traits> // For std::is_same
+#include <utility>     // For std::forward
+
+#if defined(__linux__)
+#include <sys/mman.h> // For mmap, munmap and madvise
+#endif
+
+// Allocation helpers shared by the cuckoo sets.
+//
+// The sets take an Allocator template parameter, like the standard containers, and use it for everything they
+// allocate: entries, table rows, list nodes and lock arrays. Each set rebinds it to the type it needs with
+// RebindAlloc, so any allocator for T works, including std::pmr::polymorphic_allocator<T>:
+//
+//     std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+//     CuckooSequentialSet<int, std::hash<int>, std::equal_to<int>, std::pmr::polymorphic_allocator<int>> set(32, &arena);
+//
+// Entries are stored by raw pointer, so the allocator's pointer type must be a plain pointer.
+
+// Allocator rebound to type U.
+template <typename Allocator, typename U>
+using RebindAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+// Allocate and construct one object with alloc (which allocates objects of that type).
+template <typename Allocator, typename... Args>
+typename std::allocator_traits<Allocator>::value_type *newObject(Allocator &alloc, Args &&...args)
+{
+    using Traits = std::allocator_traits<Allocator>;
+    using Value = typename Traits::value_type;
+    static_assert(std::is_same<typename Traits::pointer, Value *>::value, "the allocator must use plain pointers");
+
+    Value *object = Traits::allocate(alloc, 1);
+    try
+    {
+        Traits::construct(alloc, object, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        Traits::deallocate(alloc, object, 1); // Do not leak the memory if the constructor throws
+        throw;
+    }
+    return object;
+}
+
+// Destroy and free an object made by newObject with an equal allocator. Does nothing for null.
+template <typename Allocator>
+void deleteObject(Allocator &alloc, typename std::allocator_traits<Allocator>::value_type *object)
+{
+    using Traits = std::allocator_traits<Allocator>;
+    if (object == nullptr)
+        return;
+    Traits::destroy(alloc, object);
+    Traits::deallocate(alloc, object, 1);
+}
+
+// Allocator that backs large arrays (the hash tables and lock arrays) with 2 MiB pages.
+//
+// Random probes into a table of tens of millions of slots miss the TLB on almost every lookup with 4 KiB pages.
+// Any allocation of at least HUGE_PAGE_MIN_BYTES is rounded up to whole huge pages and mapped with mmap: first from
+// the explicit hugetlbfs pool (MAP_HUGETLB), and if that pool is empty or missing, as ordinary 2 MiB-aligned pages
+// with madvise(MADV_HUGEPAGE) so transparent huge pages can back them. Smaller allocations (entries, list nodes)
+// use ::operator new as usual. On systems without mmap every allocation uses ::operator new.
+//
+// The allocator is stateless, so every set rebinds it freely and a table grown by resize is mapped the same way:
+//
+//     CuckooSequentialSet<int, std::hash<int>, std::equal_to<int>, HugePageAllocator<int>> set(1 << 20);
+template <typename T>
+struct HugePageAllocator
+{
+    using value_type = T;
+
+    static constexpr size_t HUGE_PAGE_BYTES = size_t(2) << 20;      // Size of one huge page (2 MiB on x86-64 and arm64)
+    static constexpr size_t HUGE_PAGE_MIN_BYTES = HUGE_PAGE_BYTES / 2; // Smaller allocations are not worth a mapping
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U> &) noexcept {}
+
+    T *allocate(size_t n)
+    {
+        size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if (bytes >= HUGE_PAGE_MIN_BYTES)
+            return static_cast<T *>(mapHuge(roundUp(bytes)));
+#endif
+        return static_cast<T *>(::operator new(bytes));
+    }
+
+    void deallocate(T *p, size_t n) noexcept
+    {
+        size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if (bytes >= HUGE_PAGE_MIN_BYTES)
+        {
+            munmap(p, roundUp(bytes));
+            return;
+        }
+#endif
+        ::operator delete(p);
+    }
+
+private:
+    // Round a size up to whole huge pages
+    static size_t roundUp(size_t bytes)
+    {
+        return (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+    }
+
+#if defined(__linux__)
+    // Map bytes (a multiple of HUGE_PAGE_BYTES) backed by huge pages where the system allows it
+    static void *mapHuge(size_t bytes)
+    {
+#ifdef MAP_HUGETLB
+        void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+            return p; // Explicit huge pages from the hugetlbfs pool
+#endif
+        // Fall back to normal pages, over-mapped by one huge page so the region can be trimmed to a 2 MiB boundary
+        size_t padded = bytes + HUGE_PAGE_BYTES;
+        char *raw = static_cast<char *>(mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (raw == MAP_FAILED)
+            throw std::bad_alloc();
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(raw);
+        char *aligned = raw + (HUGE_PAGE_BYTES - address % HUGE_PAGE_BYTES) % HUGE_PAGE_BYTES;
+        if (aligned > raw)
+            munmap(raw, aligned - raw); // Drop the unaligned head
+        if (aligned + bytes < raw + padded)
+            munmap(aligned + bytes, raw + padded - (aligned + bytes)); // And the tail
+#ifdef MADV_HUGEPAGE
+        madvise(aligned, bytes, MADV_HUGEPAGE); // Ask for transparent huge pages; harmless if THP is disabled
+#endif
+        return aligned;
+    }
+#endif
+};
+
+template <typename T, typename U>
+bool operator==(const HugePageAllocator<T> &, const HugePageAllocator<U> &) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const HugePageAllocator<T> &, const HugePageAllocator<U> &) noexcept
+{
+    return false;
+}
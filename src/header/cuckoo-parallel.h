@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>  // For std::vector (partitions)
+#include <thread>  // For std::thread
+#include <utility> // For std::pair
+
+// Helpers for the parallel bulk build of populate(list, threads).
+//
+// A bulk build runs in rounds, one per table. Every key is hashed once, and the keys are grouped by which
+// range of slots their bucket in the current table falls into: one range per thread. Each thread then
+// places the keys of its own range without taking any lock, since no other thread writes to those slots,
+// and hands the keys that did not fit on to the next round, grouped by their bucket in the next table.
+// Whatever is left after the last round goes through the set's normal thread-safe add.
+
+// A key to place: its index in the input list and its Hash value.
+using BulkKey = std::pair<size_t, size_t>;
+
+// Keys grouped by the thread that produced them and the partition (range of slots) they belong to:
+// parts[t][p] are the keys thread t found for partition p.
+using BulkPartitions = std::vector<std::vector<std::vector<BulkKey>>>;
+
+// Run fn(t) for t = 0 .. threads - 1, each on its own thread, and wait for all of them.
+template <typename F>
+void runParallel(int threads, F fn)
+{
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t)
+        workers.emplace_back(fn, t);
+    fn(0); // The calling thread takes a share too
+    for (auto &worker : workers)
+        worker.join();
+}
+
+// The partition (out of threads) that owns slot index in a table of capacity slots.
+inline int partitionOf(int index, int capacity, int threads)
+{
+    return static_cast<int>(static_cast<long long>(index) * threads / capacity);
+}
+
+// Hash every value of list in parallel and group the keys by the partition of their bucket.
+// hashFn(value) gives the Hash value, bucketFn(keyHash) the slot in the first table to place into.
+template <typename T, typename HashFn, typename BucketFn>
+BulkPartitions partitionKeys(const std::vector<T> &list, int threads, int capacity, HashFn hashFn, BucketFn bucketFn)
+{
+    BulkPartitions parts(threads, std::vector<std::vector<BulkKey>>(threads));
+    runParallel(threads, [&](int t)
+                {
+        size_t begin = list.size() * t / threads;
+        size_t end = list.size() * (t + 1) / threads;
+        for (size_t index = begin; index < end; ++index)
+        {
+            size_t keyHash = hashFn(list[index]);
+            parts[t][partitionOf(bucketFn(keyHash), capacity, threads)].emplace_back(index, keyHash);
+        } });
+    return parts;
+}
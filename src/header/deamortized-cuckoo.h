@@ -0,0 +1,471 @@
+#pragma once
+
+#include <deque>      // For std::deque (the queue of pending entries)
+#include <functional> // For std::hash and std::equal_to
+#include <ctime>      // For std::time (the first salts)
+#include <cstdlib>    // For std::rand (the salts of each new table)
+#include <cstdint>    // For std::uint64_t
+#include <utility>    // For std::swap, std::forward and std::in_place
+#include <vector>     // For std::vector (populate input)
+
+#include "cuckoo-hash.h"   // For transparent lookup support and stored hashes
+#include "cuckoo-memory.h" // For allocating entries and tables with Allocator
+
+// This class implements a two-table Cuckoo Hash Set whose add does a bounded amount of work (de-amortized cuckoo
+// hashing, after Arbitman, Naor and Segev).
+//
+// CuckooSequentialSet::add runs the whole displacement loop at once, and when it gives up, rebuilds every table, so
+// one add now and then takes milliseconds. Here a new entry goes to the back of a small queue of pending entries,
+// and each add runs at most STEPS_PER_ADD steps of the displacement loop on the entry at the front of the queue.
+// A step either places the entry in hand in an empty slot, or swaps it into a slot and carries on with the occupant.
+// Lookups and removes also search the queue, which holds a handful of entries at most.
+//
+// Growing is spread over the adds as well. Once the tables pass GROW_LOAD (or the queue gets long, or an entry
+// keeps moving in a cycle), new tables twice as big are allocated, and each add clears CLEAR_PER_ADD of their
+// slots. When they are clear they become the current tables, and each add then moves the entries of
+// MIGRATE_PER_ADD old slots to the queue, until the old tables are empty. Until then, lookups also probe the old
+// tables. With these rates a migration always ends before the new tables reach GROW_LOAD.
+//
+// The slots are stored in segments of SEGMENT_SLOTS. A segment of the new tables is allocated when clearing reaches
+// it, and a segment of the old tables is freed as soon as migration has emptied it, so an add allocates or frees at
+// most one segment: releasing a table of millions of slots is not left to a single add.
+//
+// So each add does a bounded amount of work: a fixed number of slots, at most one segment allocation or release,
+// and (when a growth starts) a segment index of one pointer per SEGMENT_SLOTS slots. That is not a latency bound:
+// an add still pays whatever the allocator, Hash and KeyEqual cost. The price is a slightly lower load than
+// CuckooSequentialSet, one more indirection per probe, and up to four probes per lookup while a migration runs.
+// Entries and tables are allocated with Allocator (see cuckoo-memory.h). DeamortizedCuckooSet is not thread-safe.
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>, typename Allocator = std::allocator<T>,
+          bool StoreHash = StoreHashByDefault<T>::value>
+class DeamortizedCuckooSet
+{
+private:
+    using Entry = StoredValue<T, Hash, StoreHash>;
+    using EntryAllocator = RebindAlloc<Allocator, Entry>;
+    using SlotAllocator = RebindAlloc<Allocator, Entry *>;
+    using Segment = Entry **; // SEGMENT_SLOTS consecutive slots (fewer in the last segment of small tables).
+    using SegmentAllocator = RebindAlloc<Allocator, Segment>;
+
+    static constexpr int STEPS_PER_ADD = 16;    // Displacement steps run by each add.
+    static constexpr int CLEAR_PER_ADD = 64;    // Slots of the next tables each add clears.
+    static constexpr int MIGRATE_PER_ADD = 4;   // Slots of the old tables each add empties into the queue.
+    static constexpr int MAX_CHAIN = 64;        // Steps one entry may take before it is sent to the back of the queue.
+    static constexpr size_t QUEUE_LIMIT = 32;   // A longer queue starts growing the tables.
+    static constexpr double GROW_LOAD = 0.35;   // Load (values over slots) of the current tables that starts growing them.
+    static constexpr int SEGMENT_BITS = 12;     // Log2 of the slots per segment.
+    static constexpr size_t SEGMENT_SLOTS = size_t(1) << SEGMENT_BITS; // Slots per segment (32 KB of pointers on 64-bit).
+
+    // A pair of tables: slots 0 .. capacity-1 are table 0 and slots capacity .. 2*capacity-1 are table 1. Slot s is
+    // in segment s / SEGMENT_SLOTS, and segments that are not allocated (yet, or any more) are null.
+    struct Tables
+    {
+        Segment *segments = nullptr; // Null when there are no such tables.
+        int capacity = 0;            // Slots per table.
+        size_t salts[2] = {0, 0};
+
+        size_t slotCount() const
+        {
+            return 2 * static_cast<size_t>(capacity);
+        }
+
+        size_t segmentCount() const
+        {
+            return (slotCount() + SEGMENT_SLOTS - 1) >> SEGMENT_BITS;
+        }
+
+        // Slots in segment g (all but the last segment are full).
+        size_t segmentSize(size_t g) const
+        {
+            size_t rest = slotCount() - (g << SEGMENT_BITS);
+            return rest < SEGMENT_SLOTS ? rest : SEGMENT_SLOTS;
+        }
+
+        Entry *&slot(size_t s)
+        {
+            return segments[s >> SEGMENT_BITS][s & (SEGMENT_SLOTS - 1)];
+        }
+
+        Entry *slot(size_t s) const
+        {
+            return segments[s >> SEGMENT_BITS][s & (SEGMENT_SLOTS - 1)];
+        }
+
+        // Index of a key (whose Hash value is keyHash) in table i: its value XOR the table's salt, mixed (splitmix64
+        // finalizer), modulo capacity.
+        int index(int i, size_t keyHash) const
+        {
+            std::uint64_t x = keyHash ^ salts[i];
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return static_cast<int>((x ^ (x >> 31)) % capacity);
+        }
+
+        Entry *&at(int i, int idx)
+        {
+            return slot(static_cast<size_t>(i) * capacity + idx);
+        }
+
+        Entry *at(int i, int idx) const
+        {
+            return slot(static_cast<size_t>(i) * capacity + idx);
+        }
+
+        // Address of slot idx of table i, or null if its segment was already freed by migration.
+        Entry **find(int i, int idx) const
+        {
+            size_t s = static_cast<size_t>(i) * capacity + idx;
+            Segment segment = segments[s >> SEGMENT_BITS];
+            return segment ? &segment[s & (SEGMENT_SLOTS - 1)] : nullptr;
+        }
+    };
+
+    // An entry waiting in the queue, with the table it was last evicted from (-1 if none) and its steps so far.
+    struct Pending
+    {
+        Entry *entry;
+        int from;
+        int steps;
+    };
+
+    EntryAllocator entryAlloc;              // Allocates the entries; a rebound copy of it allocates the tables.
+    Tables current;                         // Where pending entries are placed.
+    Tables old;                             // Tables being emptied into the queue (segments is null otherwise).
+    Tables next;                            // Tables being cleared before they replace current (segments is null otherwise).
+    size_t cleared = 0;                     // Slots of next cleared so far.
+    size_t migrated = 0;                    // Slots of old emptied so far.
+    bool crowded = false;                   // An entry hit MAX_CHAIN: the current tables should grow.
+    std::deque<Pending, RebindAlloc<Allocator, Pending>> queue; // Entries not placed yet, the one in hand first.
+    int count = 0;                          // Values in the set.
+
+    // Allocate the segment index of tables of the given capacity, with no segments yet; the caller allocates each
+    // segment (allocateSegment) and clears its slots.
+    Tables allocateTables(int capacity)
+    {
+        SegmentAllocator segmentAlloc(entryAlloc);
+        Tables tables;
+        tables.capacity = capacity;
+        tables.segments = std::allocator_traits<SegmentAllocator>::allocate(segmentAlloc, tables.segmentCount());
+        for (size_t g = 0; g < tables.segmentCount(); ++g)
+            tables.segments[g] = nullptr;
+        tables.salts[0] = std::rand();
+        tables.salts[1] = std::rand();
+        return tables;
+    }
+
+    // Allocate segment g of tables (its slots are uninitialized).
+    void allocateSegment(Tables &tables, size_t g)
+    {
+        SlotAllocator slotAlloc(entryAlloc);
+        tables.segments[g] = std::allocator_traits<SlotAllocator>::allocate(slotAlloc, tables.segmentSize(g));
+    }
+
+    // Free segment g of tables, if it is allocated.
+    void freeSegment(Tables &tables, size_t g)
+    {
+        if (tables.segments[g] == nullptr)
+            return;
+        SlotAllocator slotAlloc(entryAlloc);
+        std::allocator_traits<SlotAllocator>::deallocate(slotAlloc, tables.segments[g], tables.segmentSize(g));
+        tables.segments[g] = nullptr;
+    }
+
+    // Free the segments left in tables and their index.
+    void freeTables(Tables &tables)
+    {
+        if (tables.segments == nullptr)
+            return;
+        for (size_t g = 0; g < tables.segmentCount(); ++g)
+            freeSegment(tables, g);
+        SegmentAllocator segmentAlloc(entryAlloc);
+        std::allocator_traits<SegmentAllocator>::deallocate(segmentAlloc, tables.segments, tables.segmentCount());
+        tables = Tables();
+    }
+
+    // Check whether the entry holds key (whose Hash value is keyHash), comparing the stored hash first.
+    template <typename K>
+    static bool matches(const Entry *entry, const K &key, size_t keyHash)
+    {
+        return entry && entry->hashMatches(keyHash) && KeyEqual{}(entry->value, key);
+    }
+
+    // The slot of tables holding key, or null.
+    template <typename K>
+    static Entry **find(Tables &tables, const K &key, size_t keyHash)
+    {
+        if (tables.segments == nullptr)
+            return nullptr;
+        for (int i = 0; i < 2; ++i)
+        {
+            Entry **slot = tables.find(i, tables.index(i, keyHash));
+            if (slot && matches(*slot, key, keyHash))
+                return slot;
+        }
+        return nullptr;
+    }
+
+    // Position of key in the queue, or queue.size().
+    template <typename K>
+    size_t findPending(const K &key, size_t keyHash) const
+    {
+        size_t p = 0;
+        while (p < queue.size() && !matches(queue[p].entry, key, keyHash))
+            ++p;
+        return p;
+    }
+
+    template <typename K>
+    bool containsKey(const K &key, size_t keyHash) const
+    {
+        for (const Tables *tables : {&current, &old})
+        {
+            if (tables->segments == nullptr)
+                continue;
+            for (int i = 0; i < 2; ++i)
+            {
+                Entry **slot = tables->find(i, tables->index(i, keyHash));
+                if (slot && matches(*slot, key, keyHash))
+                    return true;
+            }
+        }
+        return !queue.empty() && findPending(key, keyHash) < queue.size();
+    }
+
+    template <typename K>
+    bool removeKey(const K &key)
+    {
+        size_t keyHash = Hash{}(key);
+        Entry **slot = find(current, key, keyHash);
+        if (slot == nullptr)
+            slot = find(old, key, keyHash);
+        if (slot != nullptr)
+        {
+            deleteObject(entryAlloc, *slot);
+            *slot = nullptr;
+        }
+        else
+        {
+            size_t p = findPending(key, keyHash);
+            if (p == queue.size())
+                return false;
+            deleteObject(entryAlloc, queue[p].entry);
+            queue.erase(queue.begin() + p);
+        }
+        --count;
+        return true;
+    }
+
+    // One step of the displacement loop on the entry at the front of the queue. It takes an empty candidate slot
+    // if it has one (and leaves the queue); otherwise it evicts the occupant of the other table than the one it
+    // came from, which becomes the entry in hand.
+    void step()
+    {
+        Pending &p = queue.front();
+        size_t keyHash = p.entry->hash();
+        int idx[2] = {current.index(0, keyHash), current.index(1, keyHash)};
+        for (int t = 0; t < 2; ++t)
+        {
+            if (t != p.from && current.at(t, idx[t]) == nullptr)
+            {
+                current.at(t, idx[t]) = p.entry;
+                queue.pop_front();
+                return;
+            }
+        }
+        p.from = (p.from + 1) % 2;
+        std::swap(p.entry, current.at(p.from, idx[p.from]));
+        if (++p.steps == MAX_CHAIN) // Most likely a cycle: let the others go first, and grow.
+        {
+            queue.push_back({p.entry, p.from, 0});
+            queue.pop_front();
+            crowded = true;
+        }
+    }
+
+    // The bounded work done by every add: advance the growth of the tables by one increment, then run up to
+    // STEPS_PER_ADD displacement steps. CLEAR_PER_ADD and MIGRATE_PER_ADD are below SEGMENT_SLOTS, so an increment
+    // reaches at most one segment boundary.
+    void work()
+    {
+        if (next.segments == nullptr && old.segments == nullptr &&
+            (count > GROW_LOAD * 2 * current.capacity || queue.size() > QUEUE_LIMIT || crowded))
+        {
+            next = allocateTables(2 * current.capacity);
+            cleared = 0;
+            crowded = false;
+        }
+
+        if (next.segments != nullptr)
+        {
+            size_t total = next.slotCount();
+            for (int n = 0; n < CLEAR_PER_ADD && cleared < total; ++n)
+            {
+                if ((cleared & (SEGMENT_SLOTS - 1)) == 0) // First slot of a segment.
+                    allocateSegment(next, cleared >> SEGMENT_BITS);
+                next.slot(cleared++) = nullptr;
+            }
+            if (cleared == total) // Pending entries go to the new tables from now on.
+            {
+                old = current;
+                current = next;
+                next = Tables();
+                migrated = 0;
+            }
+        }
+        else if (old.segments != nullptr)
+        {
+            size_t total = old.slotCount();
+            for (int n = 0; n < MIGRATE_PER_ADD && migrated < total; ++n)
+            {
+                if (old.slot(migrated) != nullptr)
+                {
+                    queue.push_back({old.slot(migrated), -1, 0});
+                    old.slot(migrated) = nullptr;
+                }
+                if ((++migrated & (SEGMENT_SLOTS - 1)) == 0 || migrated == total) // Segment emptied: lookups skip it.
+                    freeSegment(old, (migrated - 1) >> SEGMENT_BITS);
+            }
+            if (migrated == total)
+                freeTables(old); // Only the index is left.
+        }
+
+        for (int n = 0; n < STEPS_PER_ADD && !queue.empty(); ++n)
+            step();
+    }
+
+    // Shared body of the add overloads: queue a new entry built from args and do the add's share of the work.
+    template <typename... Args>
+    void insert(size_t keyHash, Args &&...args)
+    {
+        queue.push_back({newObject(entryAlloc, keyHash, std::in_place, std::forward<Args>(args)...), -1, 0});
+        ++count;
+        work();
+    }
+
+public:
+    // Constructor with the initial number of slots per table (cleared right away, unlike the tables of a growth).
+    DeamortizedCuckooSet(int initialCapacity, const Allocator &alloc = Allocator())
+        : entryAlloc(alloc),
+          queue(alloc)
+    {
+        current = allocateTables(initialCapacity > 0 ? initialCapacity : 1);
+        current.salts[0] = std::time(nullptr);
+        current.salts[1] = std::time(nullptr) ^ 0x9e3779b9;
+        for (size_t g = 0; g < current.segmentCount(); ++g)
+            allocateSegment(current, g);
+        for (size_t s = 0; s < current.slotCount(); ++s)
+            current.slot(s) = nullptr;
+    }
+
+    DeamortizedCuckooSet(const DeamortizedCuckooSet &) = delete;
+    DeamortizedCuckooSet &operator=(const DeamortizedCuckooSet &) = delete;
+
+    // Free every entry (in the tables and in the queue) and the tables.
+    ~DeamortizedCuckooSet()
+    {
+        for (Tables *tables : {&current, &old})
+        {
+            if (tables->segments == nullptr)
+                continue;
+            for (size_t g = 0; g < tables->segmentCount(); ++g)
+                if (tables->segments[g] != nullptr) // Segments of old that migration emptied are already freed.
+                    for (size_t s = 0; s < tables->segmentSize(g); ++s)
+                        deleteObject(entryAlloc, tables->segments[g][s]);
+            freeTables(*tables);
+        }
+        freeTables(next);
+        for (Pending &p : queue)
+            deleteObject(entryAlloc, p.entry);
+    }
+
+    // Add a value to the set. Returns false if it is already present.
+    bool add(const T &value)
+    {
+        size_t keyHash = Hash{}(value);
+        if (containsKey(value, keyHash))
+            return false;
+        insert(keyHash, value);
+        return true;
+    }
+
+    // Add a value, moving it into its entry. The value is left untouched if it is already present.
+    bool add(T &&value)
+    {
+        size_t keyHash = Hash{}(value);
+        if (containsKey(value, keyHash))
+            return false;
+        insert(keyHash, std::move(value));
+        return true;
+    }
+
+    // Construct a value from args and add it.
+    template <typename... Args>
+    bool emplace(Args &&...args)
+    {
+        Entry *entry = newObject(entryAlloc, std::in_place, std::forward<Args>(args)...);
+        if (containsKey(entry->value, entry->hash()))
+        {
+            deleteObject(entryAlloc, entry);
+            return false;
+        }
+        queue.push_back({entry, -1, 0});
+        ++count;
+        work();
+        return true;
+    }
+
+    // Remove a value if it exists in the set.
+    bool remove(const T &value)
+    {
+        return removeKey(value);
+    }
+
+    // Remove the value equal to key (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool remove(const K &key)
+    {
+        return removeKey(key);
+    }
+
+    // Check if the value is present in the set.
+    bool contains(const T &value) const
+    {
+        return containsKey(value, Hash{}(value));
+    }
+
+    // Check if a value equal to key is present (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool contains(const K &key) const
+    {
+        return containsKey(key, Hash{}(key));
+    }
+
+    // Count how many values are stored in the set.
+    int size() const
+    {
+        return count;
+    }
+
+    // Values waiting in the queue for a slot.
+    size_t queue_length() const
+    {
+        return queue.size();
+    }
+
+    // Slots in the current tables (both of them).
+    int slot_count() const
+    {
+        return 2 * current.capacity;
+    }
+
+    // Add a list of values into the set. Returns the number of successful additions.
+    int populate(const std::vector<T> &list)
+    {
+        int added = 0;
+        for (const T &value : list)
+        {
+            if (add(value))
+                added++;
+        }
+        return added;
+    }
+};
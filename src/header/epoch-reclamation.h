@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>  // For the epoch, the counters and the retired list
+#include <cstddef> // For size_t
+
+// Epoch-based memory reclamation shared by the lock-free sets.
+//
+// A lock-free set cannot free a node or a table as soon as it unlinks it: other threads may still be reading it.
+// Every operation instead holds an EpochDomain::Guard, which announces the epoch the operation runs in (on one of
+// STRIPES counters, so threads rarely share a cache line). Unlinked objects are retired with the epoch of their
+// retirement, and an object retired in epoch e is freed once the epoch reaches e + 2: the epoch only moves on when
+// no operation of the previous epoch is still running, so by then nothing that could have seen the object is left.
+//
+// The retired list is a lock-free stack. Each thread tries to reclaim every RECLAIM_EVERY retirements; callers that
+// retire rarely but big objects (whole tables) call reclaim() themselves. The domain frees whatever is left when it
+// is destroyed, which must not happen while an operation is running.
+class EpochDomain
+{
+private:
+    static constexpr int STRIPES = 16;       // Counters of running operations
+    static constexpr int RECLAIM_EVERY = 64; // Retirements per thread between two reclaim attempts
+
+    // Running operations of one stripe, by epoch parity (on its own cache line)
+    struct alignas(64) Stripe
+    {
+        std::atomic<int> active[2] = {{0}, {0}};
+    };
+
+    // One retired object and how to free it
+    struct Retired
+    {
+        void *object;
+        void (*deleter)(void *);
+        unsigned epoch;
+        Retired *next;
+    };
+
+    std::atomic<unsigned> epoch{0};
+    Stripe stripes[STRIPES];
+    std::atomic<Retired *> retired{nullptr};
+
+    // The stripe of the calling thread, fixed when it first enters a domain
+    static int stripeOfThread()
+    {
+        static std::atomic<int> nextStripe{0};
+        thread_local int stripe = nextStripe.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+        return stripe;
+    }
+
+    // Move the epoch on if no operation of the previous epoch is still running
+    bool tryAdvance()
+    {
+        unsigned e = epoch.load();
+        for (const Stripe &stripe : stripes)
+            if (stripe.active[(e + 1) & 1].load() != 0)
+                return false;
+        return epoch.compare_exchange_strong(e, e + 1);
+    }
+
+    // Push a chain of retired objects (first .. last) back on the list
+    void pushChain(Retired *first, Retired *last)
+    {
+        Retired *head = retired.load(std::memory_order_relaxed);
+        do
+            last->next = head;
+        while (!retired.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+public:
+    // Announces an operation for its whole lifetime, so the objects it may read are not freed under it
+    class Guard
+    {
+    private:
+        EpochDomain &domain;
+        int stripe;
+        unsigned e;
+
+    public:
+        explicit Guard(EpochDomain &domain) : domain(domain), stripe(stripeOfThread())
+        {
+            for (;;)
+            {
+                e = domain.epoch.load();
+                domain.stripes[stripe].active[e & 1].fetch_add(1);
+                if (domain.epoch.load() == e)
+                    return;
+                domain.stripes[stripe].active[e & 1].fetch_sub(1); // The epoch moved on: announce the new one
+            }
+        }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+        ~Guard()
+        {
+            domain.stripes[stripe].active[e & 1].fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    // Free everything still retired
+    ~EpochDomain()
+    {
+        for (Retired *r = retired.load(); r != nullptr;)
+        {
+            Retired *next = r->next;
+            r->deleter(r->object);
+            delete r;
+            r = next;
+        }
+    }
+
+    // Retire an object that no new operation can reach any more; deleter frees it once that is safe
+    void retire(void *object, void (*deleter)(void *))
+    {
+        Retired *r = new Retired{object, deleter, epoch.load(), nullptr};
+        pushChain(r, r);
+        thread_local int retirements = 0;
+        if (++retirements % RECLAIM_EVERY == 0)
+            reclaim();
+    }
+
+    // Retire an object allocated with new
+    template <typename U>
+    void retire(U *object)
+    {
+        retire(object, [](void *p)
+               { delete static_cast<U *>(p); });
+    }
+
+    // Move the epoch on as far as possible and free every retired object no running operation can still read
+    void reclaim()
+    {
+        tryAdvance();
+        tryAdvance();
+        unsigned now = epoch.load();
+        Retired *list = retired.exchange(nullptr, std::memory_order_acquire);
+        Retired *keptFirst = nullptr, *keptLast = nullptr;
+        while (list != nullptr)
+        {
+            Retired *r = list;
+            list = list->next;
+            if (now - r->epoch >= 2)
+            {
+                r->deleter(r->object);
+                delete r;
+            }
+            else
+            {
+                r->next = keptFirst;
+                keptFirst = r;
+                if (keptLast == nullptr)
+                    keptLast = r;
+            }
+        }
+        if (keptFirst != nullptr)
+            pushChain(keptFirst, keptLast);
+    }
+};
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <array>       // For std::array (the tables and the stash)
+#include <bitset>      // For std::bitset (which slots are in use)
+#include <functional>  // For std::hash and std::equal_to
+#include <new>         // For placement new and std::launder
+#include <type_traits> // For std::aligned_storage_t and std::is_trivially_destructible
+#include <utility>     // For std::move and std::forward
+#include <vector>      // For std::vector (populate input)
+#include <cstdint>     // For std::uint64_t
+
+#include "cuckoo-hash.h" // For transparent lookup support
+
+// This class implements a small Cuckoo Hash Set of at most N values whose storage lives entirely inside the object:
+// two tables of std::array slots, a bitmap per table of which slots are used, and a small stash. Nothing is ever
+// allocated on the heap, so a FixedCuckooSet can live on the stack, and creating one only clears the bitmaps.
+//
+// Each table has SLOTS slots, the smallest power of two of at least N, so the tables are never more than half
+// full and both indexes are taken with a constexpr mask instead of a modulo. Values are stored in place (not
+// behind a pointer), and are constructed only when they are added. The two indexes come from the low and high
+// halves of the mixed Hash value, so no salt is needed and there is never a resize.
+//
+// When the displacement loop gives up, the value left in hand goes to the stash (STASH_SIZE values, searched by
+// contains only when not empty). add() returns false once the set holds N values, or when a value would need
+// the stash and the stash is full; the set is unchanged in that case. FixedCuckooSet is not thread-safe.
+template <typename T, size_t N, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class FixedCuckooSet
+{
+private:
+    // The smallest power of two of at least n.
+    static constexpr size_t ceilPow2(size_t n)
+    {
+        size_t p = 1;
+        while (p < n)
+            p *= 2;
+        return p;
+    }
+
+    // Base-2 logarithm of a power of two.
+    static constexpr int log2(size_t n)
+    {
+        return n > 1 ? 1 + log2(n / 2) : 0;
+    }
+
+    static_assert(N > 0, "a FixedCuckooSet must hold at least one value");
+
+    static constexpr size_t SLOTS = ceilPow2(N);                // Slots per table.
+    static constexpr size_t MASK = SLOTS - 1;                   // Selects an index from a hash.
+    static constexpr int STASH_SIZE = 4;                        // Values that may sit outside the tables.
+    static constexpr int MAX_DISPLACEMENTS = 2 * log2(SLOTS) + 8; // Swaps tried before a value goes to the stash.
+
+    using Slot = std::aligned_storage_t<sizeof(T), alignof(T)>; // Raw storage for one value.
+
+    std::array<Slot, SLOTS> table[2];        // Two hash tables of in-place values.
+    std::bitset<SLOTS> used[2];              // Which slots of each table hold a value.
+    std::array<Slot, STASH_SIZE> stash;      // Values that did not fit in the tables.
+    int stashCount = 0;                      // Values in the stash (stash[0 .. stashCount-1]).
+    int count = 0;                           // Values in the set.
+
+    // Mixed Hash value of a key (splitmix64 finalizer); both indexes are taken from it.
+    template <typename K>
+    static std::uint64_t hashKey(const K &key)
+    {
+        std::uint64_t x = Hash{}(key);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Index of a key in table i: the low bits of its hash for table 0, the high bits for table 1.
+    static size_t indexOf(int i, std::uint64_t h)
+    {
+        return static_cast<size_t>(i == 0 ? h : h >> 32) & MASK;
+    }
+
+    static T &valueAt(Slot &slot)
+    {
+        return *std::launder(reinterpret_cast<T *>(&slot));
+    }
+
+    static const T &valueAt(const Slot &slot)
+    {
+        return *std::launder(reinterpret_cast<const T *>(&slot));
+    }
+
+    // Try to place value in an empty slot of one of its two tables (no displacement).
+    bool placeFree(T &value, std::uint64_t h)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            size_t idx = indexOf(i, h);
+            if (!used[i][idx])
+            {
+                new (&table[i][idx]) T(std::move(value));
+                used[i][idx] = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Run the displacement loop for value (moved in and out of the slots); it needs both of its slots full.
+    // Returns true once everything is placed; otherwise value holds the homeless one.
+    bool displace(T &value, std::uint64_t h)
+    {
+        int i = 0;
+        for (int n = 0; n < MAX_DISPLACEMENTS; ++n)
+        {
+            size_t idx = indexOf(i, h);
+            if (!used[i][idx])
+            {
+                new (&table[i][idx]) T(std::move(value));
+                used[i][idx] = true;
+                return true;
+            }
+            std::swap(value, valueAt(table[i][idx])); // Evict the occupant and continue with it.
+            h = hashKey(value);
+            i = 1 - i;
+        }
+        return false;
+    }
+
+    // Where a key is: table 0 or 1 (with its index), 2 for the stash (with its position), or -1.
+    template <typename K>
+    int locate(const K &key, std::uint64_t h, size_t &where) const
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            where = indexOf(i, h);
+            if (used[i][where] && KeyEqual{}(valueAt(table[i][where]), key))
+                return i;
+        }
+        for (int s = 0; s < stashCount; ++s)
+            if (KeyEqual{}(valueAt(stash[s]), key))
+            {
+                where = s;
+                return 2;
+            }
+        return -1;
+    }
+
+    // Shared body of the add overloads; value is only moved from once it is known to fit.
+    bool insert(T &value, std::uint64_t h)
+    {
+        size_t where;
+        if (count == static_cast<int>(N) || locate(value, h, where) >= 0)
+            return false; // Full, or already present.
+        if (!placeFree(value, h))
+        {
+            if (stashCount == STASH_SIZE)
+                return false; // The displacement could end in the stash, and there is no room left.
+            T carried(std::move(value));
+            if (!displace(carried, h))
+                new (&stash[stashCount++]) T(std::move(carried));
+        }
+        ++count;
+        return true;
+    }
+
+    template <typename K>
+    bool removeKey(const K &key)
+    {
+        size_t where;
+        int i = locate(key, hashKey(key), where);
+        if (i < 0)
+            return false;
+        if (i < 2)
+        {
+            valueAt(table[i][where]).~T();
+            used[i][where] = false;
+        }
+        else
+        {
+            valueAt(stash[where]).~T(); // Keep the stash contiguous: the last value takes the freed place.
+            if (static_cast<int>(where) != stashCount - 1)
+            {
+                new (&stash[where]) T(std::move(valueAt(stash[stashCount - 1])));
+                valueAt(stash[stashCount - 1]).~T();
+            }
+            --stashCount;
+        }
+        --count;
+
+        // A slot freed up: move stashed values back into the tables where they now fit.
+        for (int s = stashCount - 1; s >= 0; --s)
+        {
+            T &stashed = valueAt(stash[s]);
+            if (placeFree(stashed, hashKey(stashed)))
+            {
+                stashed.~T();
+                if (s != stashCount - 1)
+                {
+                    new (&stash[s]) T(std::move(valueAt(stash[stashCount - 1])));
+                    valueAt(stash[stashCount - 1]).~T();
+                }
+                --stashCount;
+            }
+        }
+        return true;
+    }
+
+public:
+    FixedCuckooSet() = default;
+
+    FixedCuckooSet(const FixedCuckooSet &) = delete;
+    FixedCuckooSet &operator=(const FixedCuckooSet &) = delete;
+
+    // Destroy the stored values; nothing to do at all for trivially destructible T.
+    ~FixedCuckooSet()
+    {
+        if (!std::is_trivially_destructible<T>::value)
+            clear();
+    }
+
+    // Maximum number of values the set can hold.
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
+    // Add a value (copied into its slot). Returns false if it is already present or does not fit.
+    bool add(const T &value)
+    {
+        T copy(value);
+        return insert(copy, hashKey(copy));
+    }
+
+    // Add a value, moving it into its slot. The value is left untouched if the add fails.
+    bool add(T &&value)
+    {
+        return insert(value, hashKey(value));
+    }
+
+    // Construct a value from args and add it.
+    template <typename... Args>
+    bool emplace(Args &&...args)
+    {
+        T value(std::forward<Args>(args)...);
+        return insert(value, hashKey(value));
+    }
+
+    // Remove a value if it exists in the set.
+    bool remove(const T &value)
+    {
+        return removeKey(value);
+    }
+
+    // Remove the value equal to key (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool remove(const K &key)
+    {
+        return removeKey(key);
+    }
+
+    // Check if the value is present in the set.
+    bool contains(const T &value) const
+    {
+        size_t where;
+        return locate(value, hashKey(value), where) >= 0;
+    }
+
+    // Check if a value equal to key is present (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool contains(const K &key) const
+    {
+        size_t where;
+        return locate(key, hashKey(key), where) >= 0;
+    }
+
+    // Count how many values are stored in the set.
+    int size() const
+    {
+        return count;
+    }
+
+    // Remove every value.
+    void clear()
+    {
+        for (int i = 0; i < 2; ++i)
+            for (size_t idx = 0; idx < SLOTS; ++idx)
+                if (used[i][idx])
+                    valueAt(table[i][idx]).~T();
+        for (int s = 0; s < stashCount; ++s)
+            valueAt(stash[s]).~T();
+        used[0].reset();
+        used[1].reset();
+        stashCount = 0;
+        count = 0;
+    }
+
+    // Add a list of values into the set. Returns the number of successful additions.
+    int populate(const std::vector<T> &list)
+    {
+        int added = 0;
+        for (const T &value : list)
+        {
+            if (add(value))
+                added++;
+        }
+        return added;
+    }
+};
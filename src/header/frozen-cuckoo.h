@@ -0,0 +1,254 @@
+#pragma once
+
+#include <vector>      // For std::vector (level bits, ranks and the key array)
+#include <functional>  // For std::hash and std::equal_to
+#include <algorithm>   // For std::sort (grouping the fallback keys by hash)
+#include <cstdint>     // For std::uint64_t and std::uint32_t
+#include <utility>     // For std::move and std::pair
+
+#include "cuckoo-hash.h"   // For transparent lookup support
+#include "cuckoo-memory.h" // For RebindAlloc
+
+// This class implements an immutable hash set backed by a minimal perfect hash function (BBHash-style), produced by
+// freeze() on any of the cuckoo sets or built directly from a list of values.
+//
+// The keys live in one dense array with no empty slots (a load factor of 100%). The perfect hash is a cascade of
+// bit arrays, one per level, each GAMMA times as long as the number of keys that reach it. At build time every key
+// is mapped to one bit of level 0; the keys that land on a bit alone set it, and the keys that collide move on to
+// the next level. A key's slot in the key array is the rank of its bit: the number of set bits before it across
+// all levels. The few keys still colliding after MAX_LEVELS levels (or whose full hashes are equal) are kept at
+// the end of the key array and searched one by one.
+//
+// A lookup hashes the key once, derives each level's bit from that hash with a cheap mix, stops at the first set
+// bit (about 60% of the keys are placed at level 0 and 85% within two levels), and compares the single key
+// at its rank. A miss walks the levels the same way and fails on that one comparison. The bit arrays cost about
+// 3.3 bits per key, plus 1/3 of that for the ranks, which share a cache line with the bits they count.
+//
+// FrozenCuckooSet cannot be modified, so any number of threads can call contains at the same time without locks.
+// Keys are stored by value, so T must be move-constructible. The key array and the bit arrays use Allocator.
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>, typename Allocator = std::allocator<T>>
+class FrozenCuckooSet
+{
+private:
+    using Word = std::uint64_t;
+
+    static constexpr double GAMMA = 2.0;  // Bits per key at each level; more bits mean fewer levels but more memory.
+    static constexpr int MAX_LEVELS = 32; // Keys that still collide after this many levels go to the fallback.
+    static constexpr int WORD_BITS = 64;  // Bits per word of the level arrays.
+    static constexpr int BLOCK_WORDS = 6; // Bit words per block; with the ranks, a block fills one 64-byte cache line.
+    static constexpr size_t BLOCK_BITS = BLOCK_WORDS * WORD_BITS;
+
+    // 384 bits of the level arrays together with the number of set bits before the block and before each of its
+    // words, so testing a bit and ranking it read one cache line and count the bits of a single word.
+    struct alignas(64) Block
+    {
+        std::uint32_t rank;                // Set bits before the block.
+        std::uint16_t before[BLOCK_WORDS]; // Set bits before each word, from the start of the block.
+        Word words[BLOCK_WORDS];
+    };
+
+    // One level of the cascade: where its bits start in the shared bit array and how many there are.
+    struct Level
+    {
+        size_t firstBit;
+        size_t bits;
+    };
+
+    std::vector<Level> levels;                              // The levels, in lookup order.
+    std::vector<Block, RebindAlloc<Allocator, Block>> bits; // The bits of all levels, one after the other, with ranks.
+    std::vector<T, Allocator> keys;                         // The keys, in rank order, then the fallback keys.
+    size_t placed;                                          // Keys with a bit; keys[placed ..] are the fallback.
+
+    // Bit of a key (whose hash is keyHash) within a level of the given size: a splitmix64 finalizer over the hash
+    // and the level number, so every level sees an independent position while the key is only hashed once.
+    // The mixed value is scaled to the level with a multiply and shift instead of a division.
+    static size_t position(size_t keyHash, int level, size_t levelBits)
+    {
+        std::uint64_t x = keyHash + (static_cast<std::uint64_t>(level) + 1) * 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return static_cast<size_t>((static_cast<unsigned __int128>(x) * levelBits) >> 64);
+    }
+
+    // Number of set bits in a word. Written out (SWAR) because __builtin_popcountll becomes a library call
+    // unless the target is known to have a popcount instruction.
+    static int popcount(Word x)
+    {
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+    }
+
+    static bool testBit(const std::vector<Word> &words, size_t bit)
+    {
+        return (words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+    }
+
+    static void setBit(std::vector<Word> &words, size_t bit)
+    {
+        words[bit / WORD_BITS] |= Word(1) << (bit % WORD_BITS);
+    }
+
+    // Word of the level arrays that holds bit
+    Word &wordOf(size_t bit)
+    {
+        return bits[bit / BLOCK_BITS].words[bit % BLOCK_BITS / WORD_BITS];
+    }
+
+    // Whether bit is set, and if so its rank: the number of set bits before it (across all levels),
+    // which is the slot of the key that owns it.
+    bool rankOf(size_t bit, size_t &rank) const
+    {
+        const Block &block = bits[bit / BLOCK_BITS];
+        size_t word = bit % BLOCK_BITS / WORD_BITS;
+        Word mask = Word(1) << (bit % WORD_BITS);
+        if (!(block.words[word] & mask))
+            return false;
+        rank = block.rank + block.before[word] + popcount(block.words[word] & (mask - 1));
+        return true;
+    }
+
+    // Build the levels for values (whose hashes are hashes) and move the values into the key array.
+    void build(std::vector<T, Allocator> &values, const std::vector<size_t> &hashes)
+    {
+        std::vector<size_t> remaining(values.size()); // Indexes of the keys without a bit yet.
+        for (size_t i = 0; i < remaining.size(); ++i)
+            remaining[i] = i;
+        std::vector<std::pair<size_t, size_t>> owners; // (global bit, index) of every placed key.
+        owners.reserve(values.size());
+
+        for (int level = 0; level < MAX_LEVELS && !remaining.empty(); ++level)
+        {
+            size_t words = static_cast<size_t>(GAMMA * remaining.size()) / WORD_BITS + 1;
+            size_t levelBits = words * WORD_BITS;
+            std::vector<Word> seen(words, 0), collided(words, 0);
+            for (size_t index : remaining)
+            {
+                size_t bit = position(hashes[index], level, levelBits);
+                if (testBit(seen, bit))
+                    setBit(collided, bit);
+                else
+                    setBit(seen, bit);
+            }
+
+            size_t firstBit = levels.empty() ? 0 : levels.back().firstBit + levels.back().bits;
+            bits.resize((firstBit + levelBits) / BLOCK_BITS + 1, Block{});
+            std::vector<size_t> next; // Keys that collided at this level.
+            for (size_t index : remaining)
+            {
+                size_t bit = position(hashes[index], level, levelBits);
+                if (testBit(collided, bit))
+                    next.push_back(index);
+                else
+                    owners.emplace_back(firstBit + bit, index);
+            }
+            for (size_t w = 0; w < words; ++w)
+                wordOf(firstBit + w * WORD_BITS) = seen[w] & ~collided[w]; // Set only if a single key landed on it.
+            levels.push_back({firstBit, levelBits});
+            remaining.swap(next);
+        }
+
+        size_t count = 0;
+        for (Block &block : bits)
+        {
+            block.rank = static_cast<std::uint32_t>(count);
+            for (int w = 0; w < BLOCK_WORDS; ++w)
+            {
+                block.before[w] = static_cast<std::uint16_t>(count - block.rank);
+                count += popcount(block.words[w]);
+            }
+        }
+
+        // Order the placed keys by rank. Bits are unique, so sorting by bit gives exactly the rank order.
+        std::sort(owners.begin(), owners.end());
+        keys.reserve(owners.size() + remaining.size());
+        for (const auto &owner : owners)
+            keys.push_back(std::move(values[owner.second]));
+        placed = keys.size();
+
+        // The fallback: keys that never got a bit of their own. Equal values always share a hash, so they always
+        // collide and end up here, where the duplicates are dropped.
+        std::sort(remaining.begin(), remaining.end(), [&](size_t a, size_t b)
+                  { return hashes[a] < hashes[b]; });
+        std::vector<bool> duplicate(remaining.size(), false); // Found first, since keeping a value moves it.
+        for (size_t i = 0; i < remaining.size(); ++i)
+            for (size_t j = i; j > 0 && !duplicate[i] && hashes[remaining[j - 1]] == hashes[remaining[i]]; --j)
+                duplicate[i] = !duplicate[j - 1] && KeyEqual{}(values[remaining[j - 1]], values[remaining[i]]);
+        for (size_t i = 0; i < remaining.size(); ++i)
+            if (!duplicate[i])
+                keys.push_back(std::move(values[remaining[i]]));
+    }
+
+    // Check if a key equal to key (whose hash is keyHash) is present.
+    template <typename K>
+    bool containsKey(const K &key, size_t keyHash) const
+    {
+        for (size_t level = 0; level < levels.size(); ++level)
+        {
+            size_t rank;
+            if (rankOf(levels[level].firstBit + position(keyHash, static_cast<int>(level), levels[level].bits), rank))
+                return KeyEqual{}(keys[rank], key); // The only key that can sit behind this bit.
+        }
+        for (size_t i = placed; i < keys.size(); ++i)
+            if (KeyEqual{}(keys[i], key))
+                return true;
+        return false;
+    }
+
+public:
+    // Build the set from values, hashing each one with Hash. Duplicate values are allowed and kept once.
+    explicit FrozenCuckooSet(std::vector<T, Allocator> values, const Allocator &alloc = Allocator())
+        : bits(alloc), keys(alloc), placed(0)
+    {
+        std::vector<size_t> hashes(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            hashes[i] = Hash{}(values[i]);
+        build(values, hashes);
+    }
+
+    // Build the set from values whose hashes are already known (hashes[i] == Hash{}(values[i])), as freeze() does.
+    FrozenCuckooSet(std::vector<T, Allocator> values, const std::vector<size_t> &hashes, const Allocator &alloc = Allocator())
+        : bits(alloc), keys(alloc), placed(0)
+    {
+        build(values, hashes);
+    }
+
+    // The allocator the set was constructed with
+    Allocator get_allocator() const
+    {
+        return keys.get_allocator();
+    }
+
+    // Check if the value is present in the set.
+    bool contains(const T &value) const
+    {
+        return containsKey(value, Hash{}(value));
+    }
+
+    // Check if a value equal to key is present (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool contains(const K &key) const
+    {
+        return containsKey(key, Hash{}(key));
+    }
+
+    // Count how many values are stored in the set.
+    int size() const
+    {
+        return static_cast<int>(keys.size());
+    }
+
+    // The stored values, in no particular order (every value once).
+    const std::vector<T, Allocator> &values() const
+    {
+        return keys;
+    }
+
+    // Bytes held by the perfect hash (bits and ranks) and the key array, excluding unused vector capacity.
+    size_t memory_usage() const
+    {
+        return bits.size() * sizeof(Block) + keys.size() * sizeof(T) + levels.size() * sizeof(Level);
+    }
+};
@@ -0,0 +1,528 @@
+#pragma once
+
+#include <vector>      // For std::vector (the buckets, and the values during a resize)
+#include <functional>  // For std::hash and std::equal_to
+#include <new>         // For placement new and std::launder
+#include <type_traits> // For std::aligned_storage_t and std::is_trivially_destructible
+#include <utility>     // For std::move and std::forward
+#include <iterator>    // For std::make_move_iterator
+#include <cstdint>     // For std::uint64_t and std::uint16_t
+
+#include "cuckoo-hash.h" // For transparent lookup support
+
+// This class implements a Horton table: a bucketized cuckoo hash set in which most lookups, hits and misses alike,
+// read a single bucket (one 64-byte cache line for small T such as int), even at a load of 90% and more.
+//
+// Every value has one primary bucket, and stays there as long as the bucket has room. A bucket that overflows keeps
+// a remap array of REMAP_ENTRIES 3-bit entries: a value that does not fit hashes to one entry (its tag), and the
+// entry names which of FUNCTIONS secondary hash functions places that tag's values (0 means no value with this tag
+// ever overflowed). All overflowing values of one bucket with the same tag share that secondary bucket, so moving
+// them elsewhere only means rewriting one entry and one bucket.
+//
+// A lookup reads the primary bucket. The value is either there, or its remap entry is empty (a definite miss), and
+// only otherwise is the secondary bucket read. Primary values have priority: when a value's primary bucket is full
+// of other buckets' overflow, one of those groups is remapped to make room. When every bucket a group could move to
+// is full, room is made in one of them the same way, or by moving one of its own values to its overflow, up to
+// REMAP_DEPTH levels deep. When that fails too, or the load passes MAX_LOAD, the number of buckets is doubled.
+//
+// Values are stored in place, SLOTS per bucket (12 for int). HortonCuckooSet is not thread-safe.
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class HortonCuckooSet
+{
+private:
+    using Word = std::uint64_t;
+
+    static constexpr int HEADER_BYTES = 16; // Remap array and slot masks at the start of each bucket.
+    static constexpr int FIT_SLOTS = static_cast<int>((64 - HEADER_BYTES) / sizeof(T));
+    static constexpr int SLOTS = FIT_SLOTS < 4 ? 4 : FIT_SLOTS > 16 ? 16 : FIT_SLOTS; // Values per bucket.
+    static constexpr unsigned FULL = (1u << SLOTS) - 1;                                // Mask of every slot.
+    static constexpr int REMAP_ENTRIES = 21;   // 3-bit entries in the 64-bit remap array.
+    static constexpr int FUNCTIONS = 7;        // Secondary hash functions an entry can name (1 .. 7).
+    static constexpr int REMAP_DEPTH = 2;      // Levels of groups moved to make room for another group.
+    static constexpr double LOAD_FACTOR = 0.9; // Fraction of the slots reserve() plans to fill.
+    static constexpr double MAX_LOAD = 0.95;   // Load at which the table grows even if every value still fits.
+
+    using Slot = std::aligned_storage_t<sizeof(T), alignof(T)>; // Raw storage for one value.
+
+    struct alignas(64) Bucket
+    {
+        Word remap = 0;              // Remap entry of each tag: the secondary function of its overflow, or 0.
+        std::uint16_t used = 0;      // Bit s: slot s holds a value.
+        std::uint16_t secondary = 0; // Bit s: the value in slot s overflowed from another bucket.
+        std::uint16_t pinned = 0;    // Bit s: the value in slot s is being moved (only during an insert).
+        Slot slots[SLOTS];
+    };
+
+    std::vector<Bucket> buckets;
+    size_t count = 0; // Values in the set.
+
+    // Mix a Hash value (splitmix64 finalizer); the bucket, the tag and the secondary buckets all come from it.
+    static Word mix(Word x)
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    template <typename K>
+    static Word hashKey(const K &key)
+    {
+        return mix(Hash{}(key));
+    }
+
+    // Scale a mixed hash to the number of buckets with a multiply and shift instead of a division.
+    size_t scale(Word h) const
+    {
+        return static_cast<size_t>((static_cast<unsigned __int128>(h) * buckets.size()) >> 64);
+    }
+
+    size_t primaryOf(Word h) const
+    {
+        return scale(h);
+    }
+
+    // Tag of a value (its remap entry), from the low 32 bits of its hash.
+    static int tagOf(Word h)
+    {
+        return static_cast<int>(((h & 0xffffffffULL) * REMAP_ENTRIES) >> 32);
+    }
+
+    // Bucket where function f places the overflow of bucket b with the given tag.
+    size_t secondaryOf(size_t b, int tag, int f) const
+    {
+        return scale(mix((static_cast<Word>(b) * REMAP_ENTRIES + tag) * (FUNCTIONS + 1) + f));
+    }
+
+    static int remapAt(const Bucket &bucket, int tag)
+    {
+        return static_cast<int>((bucket.remap >> (3 * tag)) & 7);
+    }
+
+    static void setRemap(Bucket &bucket, int tag, int f)
+    {
+        bucket.remap = (bucket.remap & ~(Word(7) << (3 * tag))) | (static_cast<Word>(f) << (3 * tag));
+    }
+
+    static T &valueAt(Slot &slot)
+    {
+        return *std::launder(reinterpret_cast<T *>(&slot));
+    }
+
+    static const T &valueAt(const Slot &slot)
+    {
+        return *std::launder(reinterpret_cast<const T *>(&slot));
+    }
+
+    static int lowestBit(unsigned mask)
+    {
+        return __builtin_ctz(mask);
+    }
+
+    static int freeSlots(const Bucket &bucket)
+    {
+        int n = 0;
+        for (unsigned m = ~bucket.used & FULL; m; m &= m - 1)
+            ++n;
+        return n;
+    }
+
+    // Slot of bucket holding key, or -1.
+    template <typename K>
+    static int findIn(const Bucket &bucket, const K &key)
+    {
+        for (unsigned m = bucket.used; m; m &= m - 1)
+        {
+            int s = lowestBit(m);
+            if (KeyEqual{}(valueAt(bucket.slots[s]), key))
+                return s;
+        }
+        return -1;
+    }
+
+    // Where a key is (bucket and slot). Reads the primary bucket, and the secondary one only if the key's tag
+    // overflowed there. Returns false if the key is absent.
+    template <typename K>
+    bool locate(const K &key, Word h, size_t &b, int &slot) const
+    {
+        b = primaryOf(h);
+        if ((slot = findIn(buckets[b], key)) >= 0)
+            return true;
+        int f = remapAt(buckets[b], tagOf(h));
+        if (f == 0)
+            return false; // Nothing with this tag ever left the primary bucket.
+        b = secondaryOf(b, tagOf(h), f);
+        return (slot = findIn(buckets[b], key)) >= 0;
+    }
+
+    // Construct value in a free slot of bucket b.
+    void construct(size_t b, T &&value, bool secondary)
+    {
+        Bucket &bucket = buckets[b];
+        int s = lowestBit(~bucket.used & FULL);
+        new (&bucket.slots[s]) T(std::move(value));
+        bucket.used |= 1u << s;
+        if (secondary)
+            bucket.secondary |= 1u << s;
+    }
+
+    void destroy(Bucket &bucket, int s)
+    {
+        valueAt(bucket.slots[s]).~T();
+        bucket.used &= ~(1u << s);
+        bucket.secondary &= ~(1u << s);
+    }
+
+    // Move the overflow of bucket p with the given tag (all of it in one secondary bucket), plus extra if not null,
+    // to the secondary bucket of another function with room for all of it, the emptiest one if several do.
+    // If none has room and depth > 0, room is made in one of them by remapping the groups it holds for other buckets
+    // (at most depth levels deep). Returns false if the group could not be moved; it is then still in place.
+    bool remapGroup(size_t p, int tag, T *extra, int depth)
+    {
+        int f = remapAt(buckets[p], tag);
+        size_t from = f ? secondaryOf(p, tag, f) : p;
+        int members[SLOTS];
+        int n = 0;
+        if (f)
+            for (unsigned m = buckets[from].secondary; m; m &= m - 1)
+            {
+                int s = lowestBit(m);
+                Word h = hashKey(valueAt(buckets[from].slots[s]));
+                if (primaryOf(h) == p && tagOf(h) == tag)
+                    members[n++] = s;
+            }
+
+        int best = 0, bestFree = n + (extra ? 1 : 0) - 1;
+        for (int g = 1; g <= FUNCTIONS; ++g)
+        {
+            size_t to = secondaryOf(p, tag, g);
+            if (g == f || to == p || to == from)
+                continue;
+            int room = freeSlots(buckets[to]);
+            if (room > bestFree)
+            {
+                best = g;
+                bestFree = room;
+            }
+        }
+        if (best == 0)
+        {
+            for (int g = 1; g <= FUNCTIONS && depth > 0; ++g)
+            {
+                size_t to = secondaryOf(p, tag, g);
+                if (g != f && to != p && to != from && makeRoom(to, n + (extra ? 1 : 0), depth - 1))
+                    return remapGroup(p, tag, extra, 0); // Making room may have moved this group too, so look again.
+            }
+            return false;
+        }
+
+        size_t to = secondaryOf(p, tag, best);
+        for (int i = 0; i < n; ++i)
+        {
+            construct(to, std::move(valueAt(buckets[from].slots[members[i]])), true);
+            destroy(buckets[from], members[i]);
+        }
+        if (extra)
+            construct(to, std::move(*extra), true);
+        setRemap(buckets[p], tag, best);
+        return true;
+    }
+
+    // Move the value in slot s of bucket b out of it: with its whole group if it overflowed from another bucket, or
+    // into b's own overflow if b is its primary bucket. While it is moved, the value is pinned, so that making room
+    // further down never moves it a second time.
+    bool moveOut(size_t b, int s, int depth)
+    {
+        T &value = valueAt(buckets[b].slots[s]);
+        Word h = hashKey(value);
+        int tag = tagOf(h);
+        if ((buckets[b].secondary >> s) & 1)
+            return remapGroup(primaryOf(h), tag, nullptr, depth);
+
+        int f = remapAt(buckets[b], tag);
+        if (f && buckets[secondaryOf(b, tag, f)].used != FULL)
+            construct(secondaryOf(b, tag, f), std::move(value), true);
+        else
+        {
+            buckets[b].pinned |= 1u << s;
+            bool moved = remapGroup(b, tag, &value, depth);
+            buckets[b].pinned &= ~(1u << s);
+            if (!moved)
+                return false;
+        }
+        destroy(buckets[b], s);
+        return true;
+    }
+
+    // Free need slots of bucket b, first by remapping the groups of other buckets' overflow it holds, then by moving
+    // b's own values to its overflow. Values can move back and forth between buckets while room is made further
+    // down, so the number of attempts is bounded.
+    bool makeRoom(size_t b, int need, int depth)
+    {
+        unsigned tried = buckets[b].pinned; // Slots whose value could not be moved (or must not be).
+        for (int attempt = 0; freeSlots(buckets[b]) < need; ++attempt)
+        {
+            unsigned m = buckets[b].secondary & ~tried;
+            if (m == 0)
+                m = buckets[b].used & ~tried;
+            if (m == 0 || attempt == 2 * SLOTS)
+                return false;
+            int s = lowestBit(m);
+            if (!moveOut(b, s, depth))
+                tried |= 1u << s;
+        }
+        return true;
+    }
+
+    // Place a value known to be absent (its mixed hash is h). Returns false, leaving value untouched, if it does not fit.
+    bool insert(T &value, Word h)
+    {
+        size_t b = primaryOf(h);
+        if (buckets[b].used != FULL || makeRoom(b, 1, REMAP_DEPTH))
+        {
+            construct(b, std::move(value), false);
+            return true;
+        }
+
+        // The primary bucket is full of its own values: overflow by tag.
+        int tag = tagOf(h);
+        int f = remapAt(buckets[b], tag);
+        if (f)
+        {
+            size_t to = secondaryOf(b, tag, f);
+            if (buckets[to].used != FULL)
+            {
+                construct(to, std::move(value), true);
+                return true;
+            }
+        }
+        return remapGroup(b, tag, &value, REMAP_DEPTH);
+    }
+
+    // Move every stored value to the end of out, leaving the buckets empty.
+    void takeAll(std::vector<T> &out)
+    {
+        for (Bucket &bucket : buckets)
+            for (unsigned m = bucket.used; m; m &= m - 1)
+            {
+                int s = lowestBit(m);
+                out.push_back(std::move(valueAt(bucket.slots[s])));
+                valueAt(bucket.slots[s]).~T();
+            }
+        buckets.clear();
+        count = 0;
+    }
+
+    // Place the stored values and pending (values known to be absent) into newBuckets buckets, doubling again until
+    // everything fits.
+    void rebuild(size_t newBuckets, std::vector<T> &pending)
+    {
+        std::vector<T> values;
+        values.reserve(count + pending.size());
+        takeAll(values);
+        values.insert(values.end(), std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.end()));
+        for (;;)
+        {
+            buckets = std::vector<Bucket>(newBuckets);
+            size_t i = 0;
+            while (i < values.size() && insert(values[i], hashKey(values[i])))
+                ++i;
+            count = i;
+            if (i == values.size())
+                return;
+            std::vector<T> rest(std::make_move_iterator(values.begin() + i), std::make_move_iterator(values.end()));
+            values.swap(rest); // Values not placed yet, then the ones to take back out.
+            takeAll(values);
+            newBuckets *= 2;
+        }
+    }
+
+    // Shared body of the add overloads; value is only moved from once it is known to be new.
+    bool addValue(T &value)
+    {
+        Word h = hashKey(value);
+        size_t b;
+        int slot;
+        if (locate(value, h, b, slot))
+            return false;
+        if (count + 1 <= MAX_LOAD * SLOTS * buckets.size() && insert(value, h))
+        {
+            ++count;
+            return true;
+        }
+        std::vector<T> pending;
+        pending.push_back(std::move(value));
+        rebuild(buckets.size() * 2, pending);
+        return true;
+    }
+
+    template <typename K>
+    bool removeKey(const K &key)
+    {
+        Word h = hashKey(key);
+        size_t b;
+        int slot;
+        if (!locate(key, h, b, slot))
+            return false;
+        bool secondary = (buckets[b].secondary >> slot) & 1;
+        destroy(buckets[b], slot);
+        --count;
+
+        // Forget the remap entry once its last value is gone, so misses with this tag read one bucket again.
+        if (secondary)
+        {
+            size_t p = primaryOf(h);
+            int tag = tagOf(h);
+            for (unsigned m = buckets[b].secondary; m; m &= m - 1)
+            {
+                Word other = hashKey(valueAt(buckets[b].slots[lowestBit(m)]));
+                if (primaryOf(other) == p && tagOf(other) == tag)
+                    return true;
+            }
+            setRemap(buckets[p], tag, 0);
+        }
+        return true;
+    }
+
+    template <typename K>
+    bool containsKey(const K &key) const
+    {
+        size_t b;
+        int slot;
+        return locate(key, hashKey(key), b, slot);
+    }
+
+    // Buckets needed to hold n values at LOAD_FACTOR.
+    static size_t bucketsFor(size_t n)
+    {
+        return static_cast<size_t>(n / (SLOTS * LOAD_FACTOR)) + 1;
+    }
+
+public:
+    // Constructor sizing the table for about initialCapacity slots.
+    explicit HortonCuckooSet(int initialCapacity = 32)
+        : buckets(initialCapacity / SLOTS + 1)
+    {
+    }
+
+    ~HortonCuckooSet()
+    {
+        if (!std::is_trivially_destructible<T>::value)
+            for (Bucket &bucket : buckets)
+                for (unsigned m = bucket.used; m; m &= m - 1)
+                    valueAt(bucket.slots[lowestBit(m)]).~T();
+    }
+
+    HortonCuckooSet(const HortonCuckooSet &) = delete;
+    HortonCuckooSet &operator=(const HortonCuckooSet &) = delete;
+
+    // Add a value (copied into its slot). Returns false if it is already present.
+    bool add(const T &value)
+    {
+        T copy(value);
+        return addValue(copy);
+    }
+
+    // Add a value, moving it into its slot. The value is left untouched if it is already present.
+    bool add(T &&value)
+    {
+        return addValue(value);
+    }
+
+    // Construct a value from args and add it.
+    template <typename... Args>
+    bool emplace(Args &&...args)
+    {
+        T value(std::forward<Args>(args)...);
+        return addValue(value);
+    }
+
+    // Remove a value if it exists in the set.
+    bool remove(const T &value)
+    {
+        return removeKey(value);
+    }
+
+    // Remove the value equal to key (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool remove(const K &key)
+    {
+        return removeKey(key);
+    }
+
+    // Check if the value is present in the set.
+    bool contains(const T &value) const
+    {
+        return containsKey(value);
+    }
+
+    // Check if a value equal to key is present (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool contains(const K &key) const
+    {
+        return containsKey(key);
+    }
+
+    // Number of buckets contains reads for value: 1, or 2 when it has to follow a remap entry.
+    int buckets_probed(const T &value) const
+    {
+        Word h = hashKey(value);
+        size_t b = primaryOf(h);
+        return findIn(buckets[b], value) >= 0 || remapAt(buckets[b], tagOf(h)) == 0 ? 1 : 2;
+    }
+
+    // Count how many values are stored in the set.
+    int size() const
+    {
+        return static_cast<int>(count);
+    }
+
+    // Fraction of the slots in use.
+    double load_factor() const
+    {
+        return static_cast<double>(count) / (buckets.size() * SLOTS);
+    }
+
+    // Bytes held by the buckets.
+    size_t memory_usage() const
+    {
+        return buckets.size() * sizeof(Bucket);
+    }
+
+    // Presize the buckets for n values, so adding up to n values in total never triggers a resize.
+    void reserve(size_t n)
+    {
+        if (bucketsFor(n) > buckets.size())
+        {
+            std::vector<T> none;
+            rebuild(bucketsFor(n), none);
+        }
+    }
+
+    // Add a list of values into the set. The buckets are presized for the whole list first.
+    // Returns the number of successful additions.
+    int populate(const std::vector<T> &list)
+    {
+        reserve(size() + list.size());
+        int added = 0;
+        for (const T &value : list)
+        {
+            if (add(value))
+                added++;
+        }
+        return added;
+    }
+
+    // Add a list of values, moving each one into the set instead of copying it.
+    // Values that were already present are left in list; the others are moved-from.
+    int populate(std::vector<T> &&list)
+    {
+        reserve(size() + list.size());
+        int added = 0;
+        for (T &value : list)
+        {
+            if (add(std::move(value)))
+                added++;
+        }
+        return added;
+    }
+};
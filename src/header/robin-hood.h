@@ -0,0 +1,292 @@
+#pragma once
+
+#include <vector>      // For std::vector (the slots)
+#include <functional>  // For std::hash and std::equal_to
+#include <new>         // For placement new and std::launder
+#include <type_traits> // For std::aligned_storage_t
+#include <utility>     // For std::move, std::swap and std::forward
+#include <cstdint>     // For std::uint16_t and std::uint64_t
+
+#include "cuckoo-hash.h"   // For transparent lookup support
+#include "cuckoo-memory.h" // For RebindAlloc
+
+// This class implements a Robin Hood linear-probing hash set, as a single-threaded baseline for CuckooSequentialSet.
+//
+// Values are stored in place in one flat array of slots (for int, 8 bytes per slot: the value and its probe
+// distance), so a lookup reads consecutive memory instead of following an entry pointer into one of two tables.
+// A value is placed at the first free slot from its home slot on, but on the way it takes the slot of any value
+// that is closer to its own home (Robin Hood: take from the rich), which keeps every probe sequence short and lets
+// a lookup stop as soon as it reaches a value closer to home than the key would be.
+//
+// Removal shifts the following values of the cluster back by one slot (backward-shift deletion), so there are no
+// tombstones and lookups never slow down after many removals. The table has a power-of-two number of slots and
+// doubles once it is MAX_LOAD full. Slots are allocated with Allocator. RobinHoodSet is not thread-safe.
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>, typename Allocator = std::allocator<T>>
+class RobinHoodSet
+{
+private:
+    static constexpr double MAX_LOAD = 0.875;  // Fraction of the slots in use before the table doubles.
+    static constexpr int MAX_DISTANCE = 65535; // A value this far from home makes the table double.
+
+    // One slot: the value's probe distance plus one (0 for an empty slot), then the value itself.
+    struct Slot
+    {
+        std::uint16_t distance = 0;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        T &value() { return *std::launder(reinterpret_cast<T *>(&storage)); }
+        const T &value() const { return *std::launder(reinterpret_cast<const T *>(&storage)); }
+    };
+
+    using SlotRow = std::vector<Slot, RebindAlloc<Allocator, Slot>>;
+
+    SlotRow slots; // The table; its size is a power of two.
+    size_t mask;   // slots.size() - 1, selects the home slot from a hash.
+    int count = 0; // Values in the set.
+
+    // Home slot of a key: its Hash value mixed (splitmix64 finalizer), masked to the table size.
+    template <typename K>
+    size_t homeOf(const K &key) const
+    {
+        std::uint64_t x = Hash{}(key);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<size_t>(x ^ (x >> 31)) & mask;
+    }
+
+    // The smallest power of two of at least n (and at least 8).
+    static size_t ceilPow2(size_t n)
+    {
+        size_t p = 8;
+        while (p < n)
+            p *= 2;
+        return p;
+    }
+
+    // The slot holding key, or -1. The scan stops at the first slot whose value is closer to its home than the
+    // key would be at that point, since Robin Hood insertion would have placed the key before it.
+    template <typename K>
+    long find(const K &key) const
+    {
+        size_t i = homeOf(key);
+        for (int distance = 1; slots[i].distance >= distance; ++distance)
+        {
+            if (slots[i].distance == distance && KeyEqual{}(slots[i].value(), key))
+                return static_cast<long>(i);
+            i = (i + 1) & mask;
+        }
+        return -1;
+    }
+
+    // Place a value known not to be in the set. Returns false (with the table unchanged apart from the order of
+    // a cluster, and value holding the value still in hand) if a probe distance would exceed MAX_DISTANCE.
+    bool place(T &value)
+    {
+        size_t i = homeOf(value);
+        int distance = 1;
+        for (; slots[i].distance != 0; i = (i + 1) & mask, ++distance)
+        {
+            if (distance == MAX_DISTANCE)
+                return false;
+            if (slots[i].distance < distance) // The occupant is closer to home: it gives its slot up.
+            {
+                std::swap(value, slots[i].value());
+                int occupant = slots[i].distance;
+                slots[i].distance = static_cast<std::uint16_t>(distance);
+                distance = occupant;
+            }
+        }
+        new (&slots[i].storage) T(std::move(value));
+        slots[i].distance = static_cast<std::uint16_t>(distance);
+        return true;
+    }
+
+    // Move every value into a table of at least newSlots slots (doubling again if a value does not fit), then
+    // place pending too if it is not null.
+    void rehash(size_t newSlots, T *pending)
+    {
+        SlotRow old(slots.get_allocator());
+        old.swap(slots);
+        for (bool placed = false; !placed; newSlots *= 2)
+        {
+            slots = SlotRow(ceilPow2(newSlots), Slot(), old.get_allocator());
+            mask = slots.size() - 1;
+            placed = true;
+            for (Slot &slot : old)
+            {
+                if (slot.distance == 0)
+                    continue;
+                T value(slot.value()); // Copied, so a failed attempt leaves the old table intact.
+                if (!place(value))
+                {
+                    placed = false;
+                    break;
+                }
+            }
+            if (placed && pending != nullptr)
+            {
+                T value(*pending);
+                placed = place(value);
+            }
+            if (!placed)
+                clearSlots();
+        }
+        for (Slot &slot : old)
+            if (slot.distance != 0)
+                slot.value().~T();
+    }
+
+    // Destroy every value and mark every slot empty.
+    void clearSlots()
+    {
+        for (Slot &slot : slots)
+            if (slot.distance != 0)
+            {
+                slot.value().~T();
+                slot.distance = 0;
+            }
+    }
+
+    // Shared body of the add overloads; value is only moved from once it is known to be new.
+    bool insert(T &value)
+    {
+        if (find(value) >= 0)
+            return false;
+        if (count + 1 > MAX_LOAD * slots.size())
+            rehash(slots.size() * 2, nullptr);
+        T carried(std::move(value));
+        if (!place(carried))
+            rehash(slots.size() * 2, &carried); // carried is the value displaced last, not necessarily the new one.
+        ++count;
+        return true;
+    }
+
+    template <typename K>
+    bool removeKey(const K &key)
+    {
+        long found = find(key);
+        if (found < 0)
+            return false;
+        size_t i = static_cast<size_t>(found);
+        slots[i].value().~T();
+
+        // Backward shift: pull the rest of the cluster one slot closer to home, up to an empty slot or a value
+        // already in its home slot.
+        size_t next = (i + 1) & mask;
+        while (slots[next].distance > 1)
+        {
+            new (&slots[i].storage) T(std::move(slots[next].value()));
+            slots[next].value().~T();
+            slots[i].distance = slots[next].distance - 1;
+            i = next;
+            next = (next + 1) & mask;
+        }
+        slots[i].distance = 0;
+        --count;
+        return true;
+    }
+
+public:
+    // Constructor with the initial number of slots (rounded up to a power of two).
+    RobinHoodSet(int initialCapacity, const Allocator &alloc = Allocator())
+        : slots(ceilPow2(initialCapacity > 0 ? initialCapacity : 1), Slot(), alloc),
+          mask(slots.size() - 1)
+    {
+    }
+
+    RobinHoodSet(const RobinHoodSet &) = delete;
+    RobinHoodSet &operator=(const RobinHoodSet &) = delete;
+
+    // Destroy the stored values.
+    ~RobinHoodSet()
+    {
+        clearSlots();
+    }
+
+    // Add a value (copied into its slot). Returns false if it is already present.
+    bool add(const T &value)
+    {
+        T copy(value);
+        return insert(copy);
+    }
+
+    // Add a value, moving it into its slot. The value is left untouched if it is already present.
+    bool add(T &&value)
+    {
+        return insert(value);
+    }
+
+    // Construct a value from args and add it.
+    template <typename... Args>
+    bool emplace(Args &&...args)
+    {
+        T value(std::forward<Args>(args)...);
+        return insert(value);
+    }
+
+    // Remove a value if it exists in the set.
+    bool remove(const T &value)
+    {
+        return removeKey(value);
+    }
+
+    // Remove the value equal to key (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool remove(const K &key)
+    {
+        return removeKey(key);
+    }
+
+    // Check if the value is present in the set.
+    bool contains(const T &value) const
+    {
+        return find(value) >= 0;
+    }
+
+    // Check if a value equal to key is present (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool contains(const K &key) const
+    {
+        return find(key) >= 0;
+    }
+
+    // Count how many values are stored in the set.
+    int size() const
+    {
+        return count;
+    }
+
+    // Fraction of the slots in use.
+    double load_factor() const
+    {
+        return static_cast<double>(count) / slots.size();
+    }
+
+    // Bytes held by the slots.
+    size_t memory_usage() const
+    {
+        return slots.size() * sizeof(Slot);
+    }
+
+    // Presize the table for n values, so adding them does not have to rehash on the way.
+    void reserve(size_t n)
+    {
+        size_t needed = static_cast<size_t>(n / MAX_LOAD) + 1;
+        if (needed > slots.size())
+            rehash(needed, nullptr);
+    }
+
+    // Add a list of values into the set; the table is presized for the whole list first.
+    // Returns the number of successful additions.
+    int populate(const std::vector<T> &list)
+    {
+        reserve(count + list.size());
+        int added = 0;
+        for (const T &value : list)
+        {
+            if (add(value))
+                added++;
+        }
+        return added;
+    }
+};
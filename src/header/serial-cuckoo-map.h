@@ -0,0 +1,296 @@
+#pragma once
+
+#include <vector>     // For std::vector (dynamic arrays)
+#include <functional> // For std::hash
+#include <ctime>      // For std::time (used for hashing seeds)
+#include <cstdlib>    // For std::rand (new salts after resizing)
+#include <utility>    // For std::pair
+#include <cstdint>    // For std::uint64_t (the hash mix)
+
+#include "cuckoo-hash.h" // For transparent (heterogeneous) lookup support
+
+// This class implements a Cuckoo Hash Map using the same two-table engine as CuckooSequentialSet.
+// Each slot points to an Entry holding both the key and its value, so a single lookup answers membership
+// and returns the payload. Displacement and resizing only move Entry pointers, so the cost of a kick stays
+// one pointer swap no matter how large the value type is. CuckooSequentialMap is not thread-safe.
+// With a transparent Hash and KeyEqual (see cuckoo-hash.h), find, contains and erase accept other key types.
+
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class CuckooSequentialMap
+{
+private:
+    // Entry stores the key together with its value; the table only holds pointers to entries.
+    struct Entry
+    {
+        K key;   // The key used for hashing and comparisons.
+        V value; // The payload associated with the key.
+        Entry(const K &initKey, const V &initValue) : key(initKey), value(initValue) {}
+    };
+
+    int capacity;                            // The number of slots per table (capacity of the hash tables).
+    int maxDisplacements;                    // The maximum number of attempts to place an entry before resizing.
+    size_t salt1, salt2;                     // Two different seeds (salts) for hash functions to make them independent.
+    std::vector<std::vector<Entry *>> table; // Two hash tables (each a vector of pointers to Entry objects).
+
+    // Hash function that XORs Hash with a salt, mixes the result (splitmix64 finalizer, so the two salts give
+    // independent indexes) and takes modulo capacity.
+    // Q is K, or any type accepted by a transparent Hash.
+    template <typename Q>
+    int hash(const Q &key, size_t seed) const
+    {
+        std::uint64_t x = Hash{}(key) ^ seed;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return (x ^ (x >> 31)) % capacity;
+    }
+
+    // First hash function using salt1.
+    template <typename Q>
+    int hash1(const Q &key) const
+    {
+        return hash(key, salt1);
+    }
+
+    // Second hash function using salt2.
+    template <typename Q>
+    int hash2(const Q &key) const
+    {
+        return hash(key, salt2);
+    }
+
+    // Check whether the entry holds key.
+    template <typename Q>
+    static bool matches(const Entry *entry, const Q &key)
+    {
+        return entry && KeyEqual{}(entry->key, key);
+    }
+
+    // Swap the new entry into the specified table slot and return the old entry (can be null).
+    Entry *swap(int tableIndex, int idx, Entry *entry)
+    {
+        Entry *old = table[tableIndex][idx]; // Store the current occupant of the slot.
+        table[tableIndex][idx] = entry;      // Replace the current entry with the new entry.
+        return old;                          // Return the old entry (null if the slot was empty).
+    }
+
+    // Return the entry holding key, or null if the key is not in the map.
+    template <typename Q>
+    Entry *lookup(const Q &key) const
+    {
+        Entry *entry = table[0][hash1(key)]; // Check table 0 using hash1.
+        if (matches(entry, key))
+            return entry;
+
+        entry = table[1][hash2(key)]; // Check table 1 using hash2.
+        if (matches(entry, key))
+            return entry;
+
+        return nullptr; // The key is not present in either table.
+    }
+
+    // Remove the entry holding key. Returns false if the key is absent.
+    template <typename Q>
+    bool eraseKey(const Q &key)
+    {
+        int h1 = hash1(key); // Check table 0 using hash1.
+        if (matches(table[0][h1], key))
+        {
+            delete table[0][h1];
+            table[0][h1] = nullptr;
+            return true;
+        }
+
+        int h2 = hash2(key); // Check table 1 using hash2.
+        if (matches(table[1][h2], key))
+        {
+            delete table[1][h2];
+            table[1][h2] = nullptr;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Place an entry that is known not to be in the map yet, resizing if it does not fit.
+    void place(Entry *entry)
+    {
+        // Try to place the entry for up to maxDisplacements times.
+        for (int i = 0; i < maxDisplacements; ++i)
+        {
+            if ((entry = swap(0, hash1(entry->key), entry)) == nullptr) // Try placing in table 0.
+                return;
+            if ((entry = swap(1, hash2(entry->key), entry)) == nullptr) // Try placing in table 1.
+                return;
+        }
+        resize(entry); // The entry still in hand is carried over into the bigger table.
+    }
+
+    // Resize the table (double the size) and move every entry into the new one.
+    // pending is the entry left over from a failed placement; it is placed together with the others.
+    void resize(Entry *pending)
+    {
+        std::vector<Entry *> entries; // Every entry currently owned by the map.
+        entries.reserve(2 * capacity + 1);
+        for (auto &row : table)
+            for (auto entry : row)
+                if (entry)
+                    entries.push_back(entry);
+        entries.push_back(pending);
+
+        bool placed = false;
+        while (!placed)
+        {
+            capacity *= 2;         // Double the capacity of the hash tables.
+            maxDisplacements *= 2; // Double the maximum displacement limit.
+            table = std::vector<std::vector<Entry *>>(2, std::vector<Entry *>(capacity, nullptr));
+            salt1 = std::rand(); // New salts give a different pair of hash functions.
+            salt2 = std::rand();
+
+            placed = true;
+            for (Entry *entry : entries)
+            {
+                Entry *temp = entry;
+                for (int i = 0; i < maxDisplacements && temp != nullptr; ++i)
+                {
+                    if ((temp = swap(0, hash1(temp->key), temp)) == nullptr)
+                        break;
+                    temp = swap(1, hash2(temp->key), temp);
+                }
+                if (temp != nullptr) // Could not place everything; grow again.
+                {
+                    placed = false;
+                    break;
+                }
+            }
+        }
+    }
+
+public:
+    // Constructor to initialize capacity, maxDisplacements, salts, and table.
+    CuckooSequentialMap(int initialCapacity = 32)
+        : capacity(initialCapacity),
+          maxDisplacements(initialCapacity / 2 > 0 ? initialCapacity / 2 : 1), // Half the capacity, at least one attempt.
+          salt1(std::time(nullptr)),                                           // Use current time as salt1.
+          salt2(std::time(nullptr) ^ 0x9e3779b9),                              // Use XOR of time for salt2.
+          table(2, std::vector<Entry *>(initialCapacity, nullptr))             // Allocate two empty tables.
+    {
+    }
+
+    CuckooSequentialMap(const CuckooSequentialMap &) = delete;
+    CuckooSequentialMap &operator=(const CuckooSequentialMap &) = delete;
+
+    // Destructor to clean up dynamically allocated entries.
+    ~CuckooSequentialMap()
+    {
+        for (auto &row : table)
+            for (auto entry : row)
+                delete entry;
+    }
+
+    // Return a pointer to the value stored for key, or null if the key is absent.
+    V *find(const K &key)
+    {
+        Entry *entry = lookup(key);
+        return entry ? &entry->value : nullptr;
+    }
+
+    // Const overload of find.
+    const V *find(const K &key) const
+    {
+        Entry *entry = lookup(key);
+        return entry ? &entry->value : nullptr;
+    }
+
+    // find for any key type a transparent Hash and KeyEqual accept.
+    template <typename Q, typename = EnableIfTransparent<Hash, KeyEqual, Q>>
+    V *find(const Q &key)
+    {
+        Entry *entry = lookup(key);
+        return entry ? &entry->value : nullptr;
+    }
+
+    template <typename Q, typename = EnableIfTransparent<Hash, KeyEqual, Q>>
+    const V *find(const Q &key) const
+    {
+        Entry *entry = lookup(key);
+        return entry ? &entry->value : nullptr;
+    }
+
+    // Check if the key is present in the map.
+    bool contains(const K &key) const
+    {
+        return lookup(key) != nullptr;
+    }
+
+    template <typename Q, typename = EnableIfTransparent<Hash, KeyEqual, Q>>
+    bool contains(const Q &key) const
+    {
+        return lookup(key) != nullptr;
+    }
+
+    // Insert the pair if the key is absent. Returns false (and leaves the old value) if the key exists.
+    bool insert(const K &key, const V &value)
+    {
+        if (lookup(key))
+            return false;
+        place(new Entry(key, value));
+        return true;
+    }
+
+    // Insert the pair, or overwrite the value if the key exists. Returns true if a new key was inserted.
+    bool insert_or_assign(const K &key, const V &value)
+    {
+        if (Entry *entry = lookup(key))
+        {
+            entry->value = value;
+            return false;
+        }
+        place(new Entry(key, value));
+        return true;
+    }
+
+    // Remove the key and its value. Returns false if the key is absent.
+    bool erase(const K &key)
+    {
+        return eraseKey(key);
+    }
+
+    template <typename Q, typename = EnableIfTransparent<Hash, KeyEqual, Q>>
+    bool erase(const Q &key)
+    {
+        return eraseKey(key);
+    }
+
+    // Return the value for key, inserting a default-constructed value if the key is absent.
+    V &operator[](const K &key)
+    {
+        if (Entry *entry = lookup(key))
+            return entry->value;
+        Entry *entry = new Entry(key, V());
+        place(entry);
+        return entry->value; // Entries never move in memory, only their pointers do.
+    }
+
+    // Count how many pairs are stored in the map.
+    int size() const
+    {
+        int count = 0;
+        for (const auto &row : table)
+            for (const auto &entry : row)
+                if (entry)
+                    ++count;
+        return count;
+    }
+
+    // Insert a list of pairs into the map. Returns the number of new keys inserted.
+    int populate(const std::vector<std::pair<K, V>> &list)
+    {
+        int added = 0;
+        for (const auto &kv : list)
+        {
+            if (insert(kv.first, kv.second))
+                added++;
+        }
+        return added;
+    }
+};
@@ -2,44 +2,159 @@
 #include <iostream>   // For std::cout and std::cerr
 #include <functional> // For std::hash
 #include <ctime>      // For std::time (used for hashing seeds)
+#include <utility>    // For std::move, std::forward and std::in_place
+#include <array>      // For std::array (one salt per table)
+#include <cstdint>    // For std::uint16_t (partial-key tags) and std::uint64_t (the hash mix)
 
-// This class implements a Cuckoo Hash Set using two hash tables (Cuckoo hashing).
+#include "cuckoo-hash.h"   // For transparent lookup support and stored hashes
+#include "cuckoo-memory.h" // For allocating entries and tables with Allocator
+#include "cuckoo-build.h"  // For the offline placement solver used by build()
+#include "frozen-cuckoo.h" // For the immutable set returned by freeze()
+#include "cuckoo-bloom.h"   // For the optional prefilter in front of contains
+
+// This class implements a Cuckoo Hash Set using two hash tables (Cuckoo hashing), or D tables (see below).
 // It dynamically resizes the set when necessary and uses two hash functions with different salts to store elements. CuckooSequentialSet is a hash set implemented with two hash tables, using Cuckoo hashing to place elements. It automatically resizes when necessary.
 
-template <typename T>
+// Hash and KeyEqual default to std::hash<T> and std::equal_to<T>. If both are transparent (see cuckoo-hash.h),
+// contains and remove also accept any key type they understand, e.g. CuckooSequentialSet<std::string, StringHash, StringEqual>
+// can be queried with a std::string_view without allocating.
+// With StoreHash (the default for non-scalar T), every entry also keeps the value's full hash: probes compare it before
+// calling KeyEqual, and resizing reuses it instead of hashing every key again.
+// Entries and tables are allocated with Allocator (see cuckoo-memory.h), e.g. std::pmr::polymorphic_allocator<T>.
+// D is the number of tables, each with its own hash function (d-ary cuckoo hashing, 2 to 4). Every extra table adds
+// one probe to a lookup, but lets the tables fill much further before a resize: about 50% of the slots for two
+// tables, 91% for three and 97% for four.
+// With PartialKey (two tables only), every slot also keeps a 16-bit tag of its value's hash, and a value's slot in
+// table 1 is computed from its slot in table 0 and its tag alone (partial-key cuckoo hashing, as in MemC3). The
+// displacement loop then moves entries without reading them: no Hash call and no access to the value. Lookups also
+// compare the tag before following an entry pointer. Resizing still needs each value's full hash; with StoreHash
+// it is read from the entry, so no value is ever hashed again.
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>, typename Allocator = std::allocator<T>,
+          bool StoreHash = StoreHashByDefault<T>::value, int D = 2, bool PartialKey = false>
 class CuckooSequentialSet
 {
+    static_assert(D >= 2 && D <= 4, "CuckooSequentialSet supports 2 to 4 tables");
+    static_assert(!PartialKey || D == 2, "partial-key cuckoo hashing needs exactly two tables");
+
 private:
-    // Entry wraps the actual value; used so we can store pointers and handle nulls.
-    struct Entry
+    // Entry wraps the actual value (and its hash, with StoreHash); used so we can store pointers and handle nulls.
+    // It is built in place from a const T&, a T&&, or any T constructor arguments.
+    using Entry = StoredValue<T, Hash, StoreHash>;
+    using EntryAllocator = RebindAlloc<Allocator, Entry>;
+    using Row = std::vector<Entry *, RebindAlloc<Allocator, Entry *>>; // One hash table (a vector of pointers to Entry objects).
+    using Table = std::vector<Row, RebindAlloc<Allocator, Row>>;
+    using Tag = std::uint16_t;
+    using TagRow = std::vector<Tag, RebindAlloc<Allocator, Tag>>; // The tags of one table's slots (PartialKey only).
+
+    // Fraction of the slots reserve() plans to fill, safely below the load where cuckoo hashing with D tables
+    // starts to fail (about 0.5, 0.91 and 0.97 for two, three and four tables).
+    static constexpr double LOAD_FACTOR = D == 2 ? 0.4 : D == 3 ? 0.8 : 0.9;
+    static constexpr double MAX_LOAD = D == 2 ? 0.5 : D == 3 ? 0.91 : 0.97; // Load of a full table, for sizing the prefilter.
+    static constexpr double BUILD_LOAD_FACTOR = 0.47; // Fraction of the slots build() fills; the batch solver gets much closer to 0.5.
+
+    int capacity;               // The number of slots per table (capacity of the hash tables).
+    int maxDisplacements;       // The maximum number of attempts to place an item before resizing.
+    std::array<size_t, D> salts; // One seed (salt) per table's hash function to make them independent.
+    EntryAllocator entryAlloc;  // Allocates the entries; rebound copies of it allocate the tables.
+    Table table;                // D hash tables.
+    std::vector<TagRow, RebindAlloc<Allocator, TagRow>> tags; // Tag of each slot's value, with PartialKey (empty otherwise).
+    std::unique_ptr<BlockedBloomFilter> prefilter; // Optional prefilter for contains (null when disabled).
+    int prefilterBitsPerKey = 0;                   // Bits per key the prefilter is sized with (0 when disabled).
+
+    // D empty tables of the given capacity, allocated with entryAlloc.
+    Table makeTable(int slots) const
     {
-        T value;                                 // The actual data stored in the entry.
-        Entry(T initValue) : value(initValue) {} // Constructor to initialize 'value' with initValue.
-    };
+        return Table(D, Row(slots, nullptr, entryAlloc), entryAlloc);
+    }
+
+    // Replace the tables with empty ones of the given capacity (and their tags, with PartialKey).
+    void resetTables(int slots)
+    {
+        table = makeTable(slots);
+        if constexpr (PartialKey)
+            tags.assign(D, TagRow(slots, 0, entryAlloc));
+    }
 
-    int capacity;                            // The number of slots per table (capacity of the hash tables).
-    int maxDisplacements;                    // The maximum number of attempts to place an item before resizing.
-    bool resizing = false;                   // Flag to prevent recursive resize during the resizing process.
-    size_t salt1, salt2;                     // Two different seeds (salts) for hash functions to make them independent.
-    std::vector<std::vector<Entry *>> table; // Two hash tables (each a vector of pointers to Entry objects).
+    // Salts derived from the current time, one per table (the first two as in the two-table set).
+    static std::array<size_t, D> initialSalts()
+    {
+        std::array<size_t, D> seeds;
+        for (int i = 0; i < D; ++i)
+            seeds[i] = std::time(nullptr) ^ (0x9e3779b9 * i);
+        return seeds;
+    }
+
+    // Generate new random salts for hashing (a different hash function for every table).
+    void newSalts()
+    {
+        for (size_t &salt : salts)
+            salt = std::rand();
+    }
+
+    // Hash function that XORs a key's Hash value with a salt, mixes the result and takes modulo capacity.
+    // The key is hashed once per operation and both table indexes are derived from that value.
+    // Without the mix (splitmix64 finalizer), two salts only flip the same few bits of every key, so the tables'
+    // indexes stay correlated and the displacement loop fails at very low load.
+    int hash(size_t keyHash, size_t seed) const
+    {
+        // This function applies the XOR with the salt (seed), the mix and the modulo capacity to get the index.
+        std::uint64_t x = keyHash ^ seed;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return (x ^ (x >> 31)) % capacity;
+    }
 
-    // Hash function that XORs std::hash with a salt and takes modulo capacity.
-    int hash(const T &key, size_t seed) const
+    // Hash function of table i, using its salt.
+    int hashAt(int i, size_t keyHash) const
     {
-        // This function hashes the key using std::hash and applies the XOR with the salt (seed) and the modulo capacity to get the index.
-        return (std::hash<T>{}(key) ^ seed) % capacity;
+        return hash(keyHash, salts[i]);  // Calls the general hash function with the table's salt.
     }
 
-    // First hash function using salt1.
-    int hash1(const T &key) const
+    // Partial-key tag of a key's Hash value: 16 bits of the mixed hash (splitmix64 finalizer), never 0, so an empty
+    // slot's tag never matches.
+    static Tag tagOf(size_t keyHash)
     {
-        return hash(key, salt1);  // Calls the general hash function with salt1.
+        std::uint64_t x = keyHash;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        Tag tag = static_cast<Tag>((x ^ (x >> 31)) >> 48);
+        return tag ? tag : 1;
     }
 
-    // Second hash function using salt2.
-    int hash2(const T &key) const
+    // The other slot of a value with the given tag that sits at index i of either table: (h(tag) - i) mod capacity.
+    // altIndex(altIndex(i)) == i, so the same function leads from table 0 to table 1 and back.
+    int altIndex(int i, Tag tag) const
     {
-        return hash(key, salt2);  // Calls the general hash function with salt2.
+        int t = static_cast<int>((tag * 0x5bd1e995ULL) % capacity); // MurmurHash2 multiplier, as in CuckooFilter
+        return t >= i ? t - i : t + capacity - i;
+    }
+
+    // Index of a key (whose Hash value is keyHash) in table i.
+    int indexIn(int i, size_t keyHash) const
+    {
+        if constexpr (PartialKey)
+            return i == 0 ? hashAt(0, keyHash) : altIndex(hashAt(0, keyHash), tagOf(keyHash));
+        else
+            return hashAt(i, keyHash);
+    }
+
+    // Whether slot idx of table i holds key; with PartialKey the slot's tag is compared before the entry is read.
+    template <typename K>
+    bool slotMatches(int i, int idx, const K &key, size_t keyHash) const
+    {
+        if constexpr (PartialKey)
+            if (tags[i][idx] != tagOf(keyHash))
+                return false;
+        return matches(table[i][idx], key, keyHash);
+    }
+
+    // Check whether the entry holds key (whose Hash value is keyHash). With StoreHash, the stored hash is
+    // compared first, so KeyEqual only runs on a likely match.
+    // K is T, or any type accepted by a transparent Hash and KeyEqual.
+    template <typename K>
+    static bool matches(const Entry *entry, const K &key, size_t keyHash)
+    {
+        return entry && entry->hashMatches(keyHash) && KeyEqual{}(entry->value, key);
     }
 
     // Swap the new entry into the specified table slot and return the old entry (can be null).
@@ -51,136 +166,387 @@ private:
         return old;                           // Return the old entry (null if the slot was empty).
     }
 
-    // Resize the table (double the size) and re-add all elements from the old table into the new one.
-    void resize()
+    // Run the displacement loop for entry. Returns the entry left in hand (null if everything was placed).
+    // The entry in hand takes an empty slot among its candidates if it has one; otherwise it evicts the occupant of
+    // the next table in turn after the one it was evicted from, so with two tables the tables simply alternate.
+    // Only Entry pointers move between slots, so the stored values are never copied.
+    Entry *displace(Entry *entry)
     {
-        if (resizing) 
-            return;      // If resizing is already in progress, avoid a recursive resize.
-        resizing = true; // Mark that resizing is in progress.
+        if constexpr (PartialKey)
+            return displaceTagged(entry, tagOf(entry->hash()), hashAt(0, entry->hash()));
 
-        int oldCap = capacity; // Store the old capacity.
-        capacity *= 2;         // Double the capacity of the hash tables.
-        maxDisplacements *= 2; // Double the maximum displacement limit.
-        auto oldTable = table; // Save the old table to rehash the existing elements.
+        int from = -1; // Table the entry in hand was evicted from (none for a new entry).
+        for (int i = 0; i < maxDisplacements * D; ++i)
+        {
+            size_t keyHash = entry->hash();
+            for (int t = 0; t < D; ++t)
+            {
+                int h = hashAt(t, keyHash);
+                if (t != from && table[t][h] == nullptr) // An empty candidate slot ends the loop.
+                {
+                    table[t][h] = entry;
+                    return nullptr;
+                }
+            }
+            from = (from + 1) % D;                              // All candidates full: evict from the next table.
+            entry = swap(from, hashAt(from, keyHash), entry);
+        }
+        return entry; // Gave up after maxDisplacements rounds; this entry is still homeless.
+    }
 
-        // Create a new empty table with 2 hash tables of the new capacity.
-        table = std::vector<std::vector<Entry *>>(2, std::vector<Entry *>(capacity, nullptr));
+    // The same displacement loop with PartialKey. The entry in hand is described by its tag and its index in table 0,
+    // and both come from the slot it was evicted from, so no entry is read on the way.
+    Entry *displaceTagged(Entry *entry, Tag tag, int i0)
+    {
+        int from = -1;
+        for (int i = 0; i < maxDisplacements * 2; ++i)
+        {
+            int slots[2] = {i0, altIndex(i0, tag)};
+            for (int t = 0; t < 2; ++t)
+            {
+                if (t != from && table[t][slots[t]] == nullptr)
+                {
+                    table[t][slots[t]] = entry;
+                    tags[t][slots[t]] = tag;
+                    return nullptr;
+                }
+            }
+            from = (from + 1) % 2;
+            int s = slots[from];
+            std::swap(entry, table[from][s]); // Evict the occupant, together with its tag.
+            std::swap(tag, tags[from][s]);
+            i0 = from == 0 ? s : altIndex(s, tag);
+        }
+        return entry;
+    }
+
+    // Place an entry whose value is known not to be in the set, resizing if it does not fit.
+    void place(Entry *entry)
+    {
+        if (prefilter)
+            prefilter->insertExclusive(entry->hash());
+        Entry *leftover = displace(entry);
+        if (leftover != nullptr)
+            resize(leftover); // The entry still in hand is carried over into the bigger table.
+    }
+
+    // Resize the table (double the size) and move all entries from the old table into the new one.
+    // pending is an entry that did not fit; it is placed together with the others.
+    void resize(Entry *pending)
+    {
+        rebuild(capacity * 2, pending);
+    }
+
+    // Move all entries (plus pending, if not null) into new tables of newCapacity slots each, doubling
+    // again until everything fits. Entries are moved by pointer, so no value is copied or re-constructed.
+    void rebuild(int newCapacity, Entry *pending)
+    {
+        Row entries(entryAlloc); // Every entry currently owned by the set.
+        entries.reserve(D * capacity + 1);
+        for (auto &row : table)
+            for (auto entry : row)
+                if (entry)
+                    entries.push_back(entry);
+        if (pending)
+            entries.push_back(pending);
+
+        capacity = newCapacity;
+        maxDisplacements = capacity / 2 > 0 ? capacity / 2 : 1; // Half the capacity, as in the constructor.
+        bool placed = false;
+        while (!placed)
+        {
+            // Create a new empty table with D hash tables of the new capacity.
+            resetTables(capacity);
+
+            // New random salts ensure a different hash function after resizing.
+            newSalts();
+
+            // Re-place each entry; if one does not fit, grow again and start over.
+            placed = true;
+            for (Entry *entry : entries)
+            {
+                if (displace(entry) != nullptr)
+                {
+                    placed = false;
+                    capacity *= 2;         // Double the capacity of the hash tables.
+                    maxDisplacements *= 2; // Double the maximum displacement limit.
+                    break;
+                }
+            }
+        }
+        rebuildPrefilter();
+    }
 
-        // Generate new random salts for hashing (ensures a different hash function after resizing).
-        salt1 = std::rand();
-        salt2 = std::rand();
+    // Rebuild the prefilter (if enabled) from the current entries, sized for a full table of the current capacity.
+    // This also drops the bits of removed values.
+    void rebuildPrefilter()
+    {
+        if (prefilterBitsPerKey == 0)
+            return;
+        prefilter.reset(new BlockedBloomFilter(static_cast<size_t>(D * capacity * MAX_LOAD), prefilterBitsPerKey));
+        for (auto &row : table)
+            for (auto entry : row)
+                if (entry)
+                    prefilter->insertExclusive(entry->hash());
+    }
 
-        // Re-add each entry from the old table into the new one.
-        for (int i = 0; i < 2; ++i)
+    // A value taking part in build(): either an entry already in the set or a value from the input list.
+    struct BuildKey
+    {
+        size_t keyHash; // Hash{}(*value)
+        int bucket;     // Its slot in table 0 under the current salts
+        Entry *entry;   // The existing entry, or null for a new value
+        const T *value; // The value itself
+    };
+
+    // Place every key at once with the offline solver (see cuckoo-build.h) in tables of at least newCapacity slots,
+    // then write both tables in one pass over the slots. If the cuckoo graph has no placement, new salts are tried,
+    // and every other failure also adds 1/16 more slots. The solver handles two choices per key, so only D == 2 uses it.
+    // On the first attempt the keys sorted by bucket also drop their duplicates: equal values share a bucket.
+    void buildTables(std::vector<BuildKey> &keys, int newCapacity)
+    {
+        std::vector<std::pair<int, int>> buckets;
+        for (int attempt = 1;; ++attempt)
         {
-            for (int j = 0; j < oldCap; ++j)
+            capacity = newCapacity;
+            newSalts(); // New salts give a different cuckoo graph.
+            for (BuildKey &key : keys)
+                key.bucket = hashAt(0, key.keyHash);
+            sortByBucket(keys, capacity, [](const BuildKey &key)
+                         { return key.bucket; });
+
+            if (attempt == 1)
+            {
+                size_t kept = 0;
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    bool duplicate = false;
+                    for (size_t j = kept; j > 0 && !duplicate && keys[j - 1].bucket == keys[i].bucket; --j)
+                        duplicate = keys[j - 1].keyHash == keys[i].keyHash && KeyEqual{}(*keys[j - 1].value, *keys[i].value);
+                    if (!duplicate)
+                        keys[kept++] = keys[i];
+                }
+                keys.resize(kept);
+            }
+
+            buckets.resize(keys.size());
+            for (size_t k = 0; k < keys.size(); ++k)
+                buckets[k] = {keys[k].bucket, indexIn(1, keys[k].keyHash)};
+
+            std::vector<int> holder = solvePlacement(buckets, capacity);
+            if (!holder.empty())
             {
-                if (oldTable[i][j])
-                {                               // If the slot isn't empty, rehash the element.
-                    add(oldTable[i][j]->value); // Re-add value into the new table.
-                    delete oldTable[i][j];      // Free old memory for the element.
+                resetTables(capacity);
+                for (int slot = 0; slot < 2 * capacity; ++slot)
+                {
+                    if (holder[slot] < 0)
+                        continue;
+                    BuildKey &key = keys[holder[slot]];
+                    // New entries are allocated in slot order, so neighbouring slots point to neighbouring memory.
+                    table[slot / capacity][slot % capacity] =
+                        key.entry ? key.entry : newObject(entryAlloc, key.keyHash, std::in_place, *key.value);
+                    if constexpr (PartialKey)
+                        tags[slot / capacity][slot % capacity] = tagOf(key.keyHash);
                 }
+                break;
+            }
+            if (attempt % 2 == 0)
+                newCapacity += newCapacity / 16 + 1;
+        }
+        maxDisplacements = capacity / 2 > 0 ? capacity / 2 : 1; // Half the capacity, as in the constructor.
+        rebuildPrefilter();
+    }
+
+    // Slots per table needed to hold n values at LOAD_FACTOR.
+    static int capacityFor(size_t n)
+    {
+        return static_cast<int>(n / (D * LOAD_FACTOR)) + 1;
+    }
+
+    // Remove the value equal to key if it exists in the set.
+    template <typename K>
+    bool removeKey(const K &key)
+    {
+        size_t keyHash = Hash{}(key);
+        for (int i = 0; i < D; ++i) // Check each table using its hash function.
+        {
+            int h = indexIn(i, keyHash);
+            if (slotMatches(i, h, key, keyHash))
+            {
+                deleteObject(entryAlloc, table[i][h]); // Free memory for the entry.
+                table[i][h] = nullptr; // Mark the slot as empty.
+                return true;
             }
         }
 
-        resizing = false; // Mark the resizing process as complete.
+        return false; // Return false if the value is not found in any table.
+    }
+
+    // Check if a value equal to key (whose Hash value is keyHash) is present in the set.
+    template <typename K>
+    bool containsKey(const K &key, size_t keyHash) const
+    {
+        if (prefilter && !prefilter->mayContain(keyHash)) // Definitely absent; the tables are not touched.
+            return false;
+
+        for (int i = 0; i < D; ++i) // Check each table using its hash function.
+            if (slotMatches(i, indexIn(i, keyHash), key, keyHash))
+                return true;
+
+        return false; // Return false if the value is not found in any table.
     }
 
 public:
     // Constructor to initialize capacity, maxDisplacements, salts, and table.
-    CuckooSequentialSet(int initialCapacity)
+    CuckooSequentialSet(int initialCapacity, const Allocator &alloc = Allocator())
         : capacity(initialCapacity),
-          maxDisplacements(initialCapacity / 2),           // Set maxDisplacements to half the initial capacity.
-          salt1(std::time(nullptr)),                        // Use current time as salt1.
-          salt2(std::time(nullptr) ^ 0x9e3779b9),           // Use XOR of time for salt2.
-          table(2, std::vector<Entry *>(initialCapacity, nullptr)) // Allocate two empty tables.
+          maxDisplacements(initialCapacity / 2 > 0 ? initialCapacity / 2 : 1), // Half the initial capacity, at least one attempt.
+          salts(initialSalts()),                            // Salts from the current time.
+          entryAlloc(alloc),
+          table(makeTable(initialCapacity)),                // Allocate D empty tables.
+          tags(entryAlloc)
     {
+        if constexpr (PartialKey)
+            tags.assign(D, TagRow(initialCapacity, 0, entryAlloc));
     }
 
     // Destructor to clean up dynamically allocated memory.
     ~CuckooSequentialSet()
     {
-        for (auto &row : table)    // For each row (table 0 and table 1).
+        for (auto &row : table)    // For each row (one per table).
             for (auto entry : row) // For each entry in the row.
-                delete entry;      // Delete entry if not null.
+                deleteObject(entryAlloc, entry); // Delete entry if not null.
     }
 
-    // Add a value using Cuckoo hashing.
-    bool add(const T &value)
+    CuckooSequentialSet(const CuckooSequentialSet &) = delete;
+    CuckooSequentialSet &operator=(const CuckooSequentialSet &) = delete;
+
+    // The allocator the set was constructed with.
+    Allocator get_allocator() const
     {
-        if (contains(value)) 
-            return false;  // Avoid duplicates, return false if the value already exists.
+        return Allocator(entryAlloc);
+    }
 
-        Entry *temp = new Entry(value); // Wrap the value in a new entry object.
+    // Add a value using Cuckoo hashing (the value is copied once into its entry).
+    bool add(const T &value)
+    {
+        size_t keyHash = Hash{}(value); // Hash once for the duplicate check and the new entry.
+        if (containsKey(value, keyHash))
+            return false; // Avoid duplicates, return false if the value already exists.
 
-        // Try to place the entry for up to maxDisplacements times.
-        for (int i = 0; i < maxDisplacements; ++i)
-        {
-            int h1 = hash1(temp->value);               // Get index in table 0 using hash1.
-            if ((temp = swap(0, h1, temp)) == nullptr) // Try placing in table 0.
-                return true;                           // Success if no previous entry.
+        place(newObject(entryAlloc, keyHash, std::in_place, value)); // Wrap the value in a new entry object and place it.
+        return true;
+    }
 
-            int h2 = hash2(temp->value);               // Get index in table 1 using hash2.
-            if ((temp = swap(1, h2, temp)) == nullptr) // Try placing in table 1.
-                return true;                           // Success if no previous entry.
-        }
+    // Add a value using Cuckoo hashing, moving it into its entry instead of copying it.
+    bool add(T &&value)
+    {
+        size_t keyHash = Hash{}(value);
+        if (containsKey(value, keyHash))
+            return false; // Avoid duplicates; value is left untouched.
 
-        delete temp;       // If we gave up after maxDisplacements, free memory.
-        resize();          // Resize the table since the insertion failed.
-        return add(value); // Try again after resizing.
+        place(newObject(entryAlloc, keyHash, std::in_place, std::move(value)));
+        return true;
     }
 
-    // Remove a value if it exists in the set.
-    bool remove(const T &value)
+    // Construct a value in place from args and add it. The value is built once, directly inside its entry.
+    template <typename... Args>
+    bool emplace(Args &&...args)
     {
-        int h1 = hash1(value); // Check table 0 using hash1.
-        if (table[0][h1] && table[0][h1]->value == value)
+        Entry *entry = newObject(entryAlloc, std::in_place, std::forward<Args>(args)...);
+        if (containsKey(entry->value, entry->hash()))
         {
-            delete table[0][h1];    // Free memory for the entry.
-            table[0][h1] = nullptr; // Mark the slot as empty.
-            return true;
+            deleteObject(entryAlloc, entry); // Duplicate; discard the freshly built value.
+            return false;
         }
+        place(entry);
+        return true;
+    }
 
-        int h2 = hash2(value); // Check table 1 using hash2.
-        if (table[1][h2] && table[1][h2]->value == value)
-        {
-            delete table[1][h2];   // Free memory for the entry.
-            table[1][h2] = nullptr; // Mark the slot as empty.
-            return true;
-        }
+    // Remove a value if it exists in the set.
+    bool remove(const T &value)
+    {
+        return removeKey(value);
+    }
 
-        return false; // Return false if the value is not found in either table.
+    // Remove the value equal to key (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool remove(const K &key)
+    {
+        return removeKey(key);
     }
 
     // Check if the value is present in the set.
     bool contains(const T &value) const
     {
-        int h1 = hash1(value); // Check table 0 using hash1.
-        if (table[0][h1] && table[0][h1]->value == value)
-            return true;
+        return containsKey(value, Hash{}(value));
+    }
 
-        int h2 = hash2(value); // Check table 1 using hash2.
-        if (table[1][h2] && table[1][h2]->value == value)
-            return true;
+    // Check if a value equal to key is present (only with a transparent Hash and KeyEqual).
+    template <typename K, typename = EnableIfTransparent<Hash, KeyEqual, K>>
+    bool contains(const K &key) const
+    {
+        return containsKey(key, Hash{}(key));
+    }
+
+    // Put a blocked Bloom filter (see cuckoo-bloom.h) in front of contains, so most misses return without probing
+    // the tables. It is kept up to date by every add and rebuilt whenever the tables are. Costs bitsPerKey bits per
+    // value of a full table.
+    void enable_prefilter(int bitsPerKey = 10)
+    {
+        prefilterBitsPerKey = bitsPerKey;
+        rebuildPrefilter();
+    }
 
-        return false; // Return false if the value is not found in either table.
+    // Drop the prefilter; contains probes the tables again for every key.
+    void disable_prefilter()
+    {
+        prefilterBitsPerKey = 0;
+        prefilter.reset();
+    }
+
+    // Whether contains is prefiltered.
+    bool has_prefilter() const
+    {
+        return prefilter != nullptr;
     }
 
     // Count how many entries are stored in the set (non-thread-safe).
     int size() const
     {
         int count = 0;
-        for (const auto &row : table)     // For each row (table 0 and 1).
+        for (const auto &row : table)     // For each row (one per table).
             for (const auto &entry : row) // For each slot in the row.
                 if (entry)               // If the slot is not empty, increment the count.
                     ++count;
         return count; // Return the total count of non-null entries.
     }
 
+    // Total number of slots over the D tables; size() / slot_count() is the current load.
+    size_t slot_count() const
+    {
+        return static_cast<size_t>(D) * capacity;
+    }
+
+    // Presize the tables for n values, so adding up to n values in total never triggers a resize.
+    void reserve(size_t n)
+    {
+        if (capacityFor(n) > capacity)
+            rebuild(capacityFor(n), nullptr);
+    }
+
+    // Rebuild the tables with newCapacity slots each (or more, if the current values need it) and new hash functions.
+    void rehash(int newCapacity)
+    {
+        int needed = capacityFor(size());
+        rebuild(newCapacity > needed ? newCapacity : needed, nullptr);
+    }
+
     // Add a list of values into the set (non-thread-safe).
-    // Returns the number of successful additions.
+    // The tables are presized for the whole list first. Returns the number of successful additions.
     int populate(const std::vector<T> &list)
     {
+        reserve(size() + list.size());
         int added = 0;
         for (const T &value : list)
         {
@@ -191,4 +557,59 @@ public:
         }
         return added; // Return the total number of successful additions.
     }
+
+    // Bulk-construct the set from list: the values already in the set and the new ones are placed all at once by the
+    // offline solver instead of one displacement loop per value, at a higher load (BUILD_LOAD_FACTOR) than incremental
+    // adds can sustain. Meant for sets that are built once and then mostly queried. Returns the number of new values.
+    // With more than two tables, incremental adds already reach a high load, and build() is the same as populate().
+    int build(const std::vector<T> &list)
+    {
+        if constexpr (D != 2)
+            return populate(list);
+
+        std::vector<BuildKey> keys; // Existing entries first, so they win over equal values from the list.
+        keys.reserve(size() + list.size());
+        for (auto &row : table)
+            for (auto entry : row)
+                if (entry)
+                    keys.push_back({entry->hash(), 0, entry, &entry->value});
+        size_t existing = keys.size();
+        for (const T &value : list)
+            keys.push_back({Hash{}(value), 0, nullptr, &value});
+
+        buildTables(keys, static_cast<int>(keys.size() / (2 * BUILD_LOAD_FACTOR)) + 1);
+        return static_cast<int>(keys.size() - existing);
+    }
+
+    // Copy the values into an immutable FrozenCuckooSet (one probe per lookup, no empty slots). The stored hashes are
+    // reused where the entries keep them. The set itself is left unchanged (non-thread-safe).
+    FrozenCuckooSet<T, Hash, KeyEqual, Allocator> freeze() const
+    {
+        std::vector<T, Allocator> values(get_allocator());
+        std::vector<size_t> hashes;
+        values.reserve(size());
+        hashes.reserve(values.capacity());
+        for (const auto &row : table)
+            for (auto entry : row)
+                if (entry)
+                {
+                    values.push_back(entry->value);
+                    hashes.push_back(entry->hash());
+                }
+        return FrozenCuckooSet<T, Hash, KeyEqual, Allocator>(std::move(values), hashes, get_allocator());
+    }
+
+    // Add a list of values, moving each one into the set instead of copying it (non-thread-safe).
+    // Values that were already present are left in list; the others are moved-from.
+    int populate(std::vector<T> &&list)
+    {
+        reserve(size() + list.size());
+        int added = 0;
+        for (T &value : list)
+        {
+            if (add(std::move(value)))
+                added++;
+        }
+        return added;
+    }
 };
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <vector>     // For std::vector (populate input)
+#include <functional> // For std::hash and std::equal_to
+#include <atomic>     // For the list links, the bucket directory and the counters
+#include <memory>     // For std::unique_ptr (the bucket directory)
+#include <cstdint>    // For std::uint64_t and std::uintptr_t
+
+#include "cuckoo-parallel.h"   // For runParallel (the threaded populate)
+#include "epoch-reclamation.h" // For freeing removed nodes safely
+
+// This class implements a split-ordered list (Shalev and Shavit), a lock-free hash set that grows without ever
+// moving a value, to compare with the global resize of the concurrent cuckoo set.
+
+// All values live in one lock-free linked list (Harris and Michael: a node is removed by marking its next link,
+// then unlinking it), sorted by the bit-reversed hash of each value. In that order the values of bucket b of a table
+// of 2^k buckets are contiguous, and doubling the table splits every bucket into two that are still contiguous: the
+// list never changes when the table grows, only the number of buckets does.
+
+// Every bucket is a pointer to a sentinel node at the start of its part of the list. Buckets are initialized lazily,
+// the first time an operation needs them: the sentinel of bucket b is inserted starting from its parent bucket (b
+// without its highest set bit), which is initialized first if needed. Growing the table is then a single CAS that
+// doubles the bucket count, once the set holds MAX_LOAD values per bucket.
+
+// The bucket directory is a fixed array of segments of SEGMENT_SIZE buckets, each allocated the first time one of
+// its buckets is initialized, so the table can grow up to MAX_BUCKETS without copying the directory either.
+// Removed nodes are freed with epoch-based reclamation (see epoch-reclamation.h).
+template <class T, class Hash = std::hash<T>, class KeyEqual = std::equal_to<T>>
+class SplitOrderedSet
+{
+private:
+    static constexpr double MAX_LOAD = 2.0;          // Values per bucket that double the bucket count
+    static constexpr size_t SEGMENT_SIZE = 4096;     // Buckets per segment of the directory
+    static constexpr size_t SEGMENTS = 4096;         // Segments of the directory
+    static constexpr size_t MAX_BUCKETS = SEGMENT_SIZE * SEGMENTS;
+
+    // A node of the list; sentinels have an even key, values an odd one
+    struct Node
+    {
+        std::uint64_t key;           // Split-order key: the bit-reversed hash (or bucket, for a sentinel)
+        std::atomic<Node *> next;    // The next node; the low bit marks this node as removed
+
+        explicit Node(std::uint64_t key) : key(key), next(nullptr) {}
+    };
+
+    struct ValueNode : Node
+    {
+        T value;
+
+        ValueNode(std::uint64_t key, const T &value) : Node(key), value(value) {}
+    };
+
+    using Bucket = std::atomic<Node *>;
+
+    Node *head;                                       // Sentinel of bucket 0, the start of the list
+    std::unique_ptr<std::atomic<Bucket *>[]> segments; // The bucket directory
+    std::atomic<size_t> bucketCount;                  // Buckets in use (a power of two)
+    std::atomic<int> count{0};                        // Number of values in the set
+    EpochDomain epochs;                               // Frees removed nodes once no operation can read them
+
+    static bool isMarked(Node *p)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) & 1;
+    }
+
+    static Node *marked(Node *p)
+    {
+        return reinterpret_cast<Node *>(reinterpret_cast<std::uintptr_t>(p) | 1);
+    }
+
+    static Node *unmarked(Node *p)
+    {
+        return reinterpret_cast<Node *>(reinterpret_cast<std::uintptr_t>(p) & ~std::uintptr_t(1));
+    }
+
+    static std::uint64_t reverseBits(std::uint64_t x)
+    {
+        x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+        x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+        x = ((x >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((x & 0x0f0f0f0f0f0f0f0fULL) << 4);
+        return __builtin_bswap64(x);
+    }
+
+    // Hash value of a key (splitmix64 finalizer of its Hash value)
+    static std::uint64_t hashOf(const T &value)
+    {
+        std::uint64_t x = Hash{}(value);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Split-order key of a value: its hash reversed, with the lowest bit set so it sorts after its bucket's sentinel
+    static std::uint64_t valueKey(std::uint64_t hash)
+    {
+        return reverseBits(hash | (std::uint64_t(1) << 63));
+    }
+
+    static std::uint64_t sentinelKey(size_t bucket)
+    {
+        return reverseBits(bucket);
+    }
+
+    // The bucket a bucket splits from: b without its highest set bit
+    static size_t parentOf(size_t bucket)
+    {
+        size_t bit = size_t(1) << (63 - __builtin_clzll(bucket));
+        return bucket & ~bit;
+    }
+
+    // The directory slot of a bucket, allocating its segment if needed
+    Bucket &slotOf(size_t bucket)
+    {
+        std::atomic<Bucket *> &segment = segments[bucket / SEGMENT_SIZE];
+        Bucket *buckets = segment.load(std::memory_order_acquire);
+        if (buckets == nullptr)
+        {
+            Bucket *fresh = new Bucket[SEGMENT_SIZE];
+            for (size_t i = 0; i < SEGMENT_SIZE; ++i)
+                fresh[i].store(nullptr, std::memory_order_relaxed);
+            if (segment.compare_exchange_strong(buckets, fresh))
+                buckets = fresh;
+            else
+                delete[] fresh; // Another thread allocated it first
+        }
+        return buckets[bucket % SEGMENT_SIZE];
+    }
+
+    // Search the list from start for the first node with key at least key that is not before a match. Returns
+    // true if a node with this key satisfies matches (set in cur); otherwise cur is the node a new one goes before.
+    // In both cases prev is the link that points to cur. Marked nodes met on the way are unlinked and retired.
+    template <typename Match>
+    bool find(Node *start, std::uint64_t key, Match matches, std::atomic<Node *> *&prev, Node *&cur)
+    {
+    retry:
+        prev = &start->next;
+        cur = prev->load(std::memory_order_acquire);
+        while (cur != nullptr)
+        {
+            Node *next = cur->next.load(std::memory_order_acquire);
+            if (isMarked(next))
+            {
+                // cur is removed: unlink it; if prev changed meanwhile, start over
+                Node *expected = cur;
+                if (!prev->compare_exchange_strong(expected, unmarked(next)))
+                    goto retry;
+                epochs.retire(static_cast<ValueNode *>(cur));
+                cur = unmarked(next);
+                continue;
+            }
+            if (cur->key > key)
+                return false;
+            if (cur->key == key && matches(cur))
+                return true;
+            prev = &cur->next;
+            cur = next;
+        }
+        return false;
+    }
+
+    // Find the value in the list from start
+    bool findValue(Node *start, std::uint64_t key, const T &value, std::atomic<Node *> *&prev, Node *&cur)
+    {
+        return find(start, key, [&](Node *node)
+                    { return KeyEqual{}(static_cast<ValueNode *>(node)->value, value); }, prev, cur);
+    }
+
+    // Insert the sentinel of a bucket after initializing its parent, and record it in the directory
+    Node *initializeBucket(size_t bucket)
+    {
+        Node *parent = bucketHead(parentOf(bucket));
+        std::uint64_t key = sentinelKey(bucket);
+        Node *sentinel = nullptr;
+        for (;;)
+        {
+            std::atomic<Node *> *prev;
+            Node *cur;
+            if (find(parent, key, [](Node *)
+                     { return true; }, prev, cur))
+            {
+                delete sentinel; // Another thread inserted it first
+                sentinel = cur;
+                break;
+            }
+            if (sentinel == nullptr)
+                sentinel = new Node(key);
+            sentinel->next.store(cur, std::memory_order_relaxed);
+            if (prev->compare_exchange_strong(cur, sentinel))
+                break;
+        }
+        slotOf(bucket).store(sentinel, std::memory_order_release);
+        return sentinel;
+    }
+
+    // The sentinel of a bucket, initializing the bucket if needed
+    Node *bucketHead(size_t bucket)
+    {
+        Node *sentinel = slotOf(bucket).load(std::memory_order_acquire);
+        return sentinel != nullptr ? sentinel : initializeBucket(bucket);
+    }
+
+    // The sentinel a value's search starts from
+    Node *startOf(std::uint64_t hash)
+    {
+        return bucketHead(hash & (bucketCount.load(std::memory_order_relaxed) - 1));
+    }
+
+    // The smallest power of two of at least n (and at least 2), capped at MAX_BUCKETS
+    static size_t ceilPow2(size_t n)
+    {
+        size_t p = 2;
+        while (p < n && p < MAX_BUCKETS)
+            p *= 2;
+        return p;
+    }
+
+    // Double the bucket count if the set holds more than MAX_LOAD values per bucket
+    void grow()
+    {
+        size_t buckets = bucketCount.load(std::memory_order_relaxed);
+        if (count.load(std::memory_order_relaxed) > MAX_LOAD * buckets && buckets < MAX_BUCKETS)
+            bucketCount.compare_exchange_strong(buckets, buckets * 2);
+    }
+
+public:
+    // Constructor with the initial number of buckets (rounded up to a power of two)
+    SplitOrderedSet(int initial_capacity)
+        : head(new Node(0)), segments(new std::atomic<Bucket *>[SEGMENTS]),
+          bucketCount(ceilPow2(initial_capacity > 0 ? initial_capacity : 1))
+    {
+        for (size_t i = 0; i < SEGMENTS; ++i)
+            segments[i].store(nullptr, std::memory_order_relaxed);
+        slotOf(0).store(head);
+    }
+
+    SplitOrderedSet(const SplitOrderedSet &) = delete;
+    SplitOrderedSet &operator=(const SplitOrderedSet &) = delete;
+
+    // Free the list and the directory (epochs frees the unlinked nodes); no operation may be running
+    ~SplitOrderedSet()
+    {
+        for (Node *node = head; node != nullptr;)
+        {
+            Node *next = unmarked(node->next.load());
+            if (node->key & 1)
+                delete static_cast<ValueNode *>(node);
+            else
+                delete node;
+            node = next;
+        }
+        for (size_t i = 0; i < SEGMENTS; ++i)
+            delete[] segments[i].load();
+    }
+
+    // Add a value to the set
+    bool add(const T &val)
+    {
+        EpochDomain::Guard guard(epochs);
+        std::uint64_t hash = hashOf(val);
+        std::uint64_t key = valueKey(hash);
+        Node *start = startOf(hash);
+        ValueNode *node = nullptr;
+        for (;;)
+        {
+            std::atomic<Node *> *prev;
+            Node *cur;
+            if (findValue(start, key, val, prev, cur))
+            {
+                delete node;
+                return false;
+            }
+            if (node == nullptr)
+                node = new ValueNode(key, val);
+            node->next.store(cur, std::memory_order_relaxed);
+            if (prev->compare_exchange_strong(cur, node))
+                break;
+        }
+        count++;
+        grow();
+        return true;
+    }
+
+    // Remove a value if it is present: mark its node, then unlink it (or leave that to the next search that meets it)
+    bool remove(const T &val)
+    {
+        EpochDomain::Guard guard(epochs);
+        std::uint64_t hash = hashOf(val);
+        std::uint64_t key = valueKey(hash);
+        Node *start = startOf(hash);
+        for (;;)
+        {
+            std::atomic<Node *> *prev;
+            Node *cur;
+            if (!findValue(start, key, val, prev, cur))
+                return false;
+            Node *next = cur->next.load(std::memory_order_acquire);
+            if (isMarked(next) || !cur->next.compare_exchange_strong(next, marked(next)))
+                continue; // Removed or changed meanwhile: search again
+            Node *expected = cur;
+            if (prev->compare_exchange_strong(expected, next))
+                epochs.retire(static_cast<ValueNode *>(cur));
+            else
+                findValue(start, key, val, prev, cur); // Unlinks it
+            count--;
+            return true;
+        }
+    }
+
+    // Check if a value is present in the set
+    bool contains(const T &val)
+    {
+        EpochDomain::Guard guard(epochs);
+        std::uint64_t hash = hashOf(val);
+        std::atomic<Node *> *prev;
+        Node *cur;
+        return findValue(startOf(hash), valueKey(hash), val, prev, cur);
+    }
+
+    // Number of values in the set
+    int size() const
+    {
+        return count.load();
+    }
+
+    // Buckets in use (not all of them need be initialized yet)
+    size_t bucket_count() const
+    {
+        return bucketCount.load();
+    }
+
+    // Raise the bucket count for n values; the buckets are still only initialized when first used
+    void reserve(size_t n)
+    {
+        size_t needed = ceilPow2(static_cast<size_t>(n / MAX_LOAD) + 1);
+        size_t buckets = bucketCount.load();
+        while (buckets < needed && !bucketCount.compare_exchange_weak(buckets, needed))
+            ;
+    }
+
+    // Add a list of values
+    int populate(const std::vector<T> &list)
+    {
+        reserve(size() + list.size());
+        int added = 0;
+        for (const T &value : list)
+        {
+            if (add(value))
+                added++;
+        }
+        return added;
+    }
+
+    // Add a list of values using the given number of threads, each adding its share with the lock-free add
+    int populate(const std::vector<T> &list, int threads)
+    {
+        if (threads <= 1)
+            return populate(list);
+        reserve(size() + list.size());
+        std::atomic<int> added{0};
+        runParallel(threads, [&](int t)
+                    {
+            size_t begin = list.size() * t / threads;
+            size_t end = list.size() * (t + 1) / threads;
+            for (size_t index = begin; index < end; ++index)
+                if (add(list[index]))
+                    added++; });
+        return added.load();
+    }
+};
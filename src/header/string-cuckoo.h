@@ -0,0 +1,297 @@
+#pragma once
+
+#include <vector>      // For std::vector (tables and the key arena)
+#include <string>      // For std::string (populate input)
+#include <string_view> // For std::string_view (keys are read straight out of the arena)
+#include <functional>  // For std::hash
+#include <ctime>       // For std::time (used for hashing seeds)
+#include <cstdlib>     // For std::rand (new salts after resizing)
+#include <cstdint>     // For std::uint64_t and std::uint32_t
+#include <cstring>     // For std::memcpy (unaligned length prefixes)
+#include <utility>     // For std::pair
+
+// This class implements a Cuckoo Hash Set specialized for string keys, using the same two-table engine as
+// CuckooSequentialSet. Instead of one heap-allocated std::string per key, every key's bytes are appended to a
+// single contiguous arena, stored as a 4-byte length followed by the characters. Each table slot is one 64-bit
+// word: the low 48 bits are the record's offset in the arena and the high 16 bits are a fingerprint of the
+// key's hash. An empty slot is the word 0 (fingerprints are never 0).
+//
+// A probe compares the fingerprint first, so a miss reads the arena only about once in 65536 slots, and a key
+// costs 8 bytes per slot plus 4 bytes of length instead of an Entry, a pointer and a std::string header.
+// Removing a key only clears its slot; the bytes it leaves behind in the arena are reclaimed when the tables are
+// rebuilt on a resize, or by compacting the arena alone: the live records are copied into a fresh arena and each
+// slot's offset is rewritten in place, with no rehashing. A remove compacts once garbage is more than half the
+// arena and at least the size of the tables, since compacting scans every slot; the scan is then paid for by at
+// least as many removed bytes. Add/remove churn keeps the arena within twice its live size plus the size of the
+// tables. Displaced keys are rehashed from their arena bytes, since slots only keep 16 bits of the hash.
+// CuckooStringSet is not thread-safe.
+
+class CuckooStringSet
+{
+private:
+    using Slot = std::uint64_t; // 16-bit fingerprint << 48 | 48-bit arena offset; 0 means empty.
+
+    static constexpr int OFFSET_BITS = 48;                                 // Bits of a slot holding the arena offset.
+    static constexpr Slot OFFSET_MASK = (Slot(1) << OFFSET_BITS) - 1;      // Selects the offset from a slot.
+    static constexpr size_t LENGTH_BYTES = sizeof(std::uint32_t);          // Size of the length prefix of a record.
+
+    int capacity;                          // The number of slots per table (capacity of the hash tables).
+    int maxDisplacements;                  // The maximum number of attempts to place a key before resizing.
+    int count;                             // The number of keys in the set.
+    size_t salt1, salt2;                   // Two different seeds (salts) for hash functions to make them independent.
+    std::vector<std::vector<Slot>> table;  // Two hash tables (each a vector of packed slots).
+    std::vector<char> arena;               // Length-prefixed key records, appended in insertion order.
+    size_t garbage;                        // Arena bytes that belong to removed keys.
+
+    // Hash a key once per operation; both table indexes and the fingerprint are derived from this value.
+    static size_t hashKey(std::string_view key)
+    {
+        return std::hash<std::string_view>{}(key);
+    }
+
+    // Fingerprint stored in the high bits of a slot (forced non-zero so that 0 still means empty).
+    static Slot fingerprint(size_t keyHash)
+    {
+        Slot tag = static_cast<Slot>(keyHash >> (sizeof(size_t) * 8 - 16)) & 0xffff;
+        return tag ? tag : 1;
+    }
+
+    // Build the slot for a record at offset whose key hashes to keyHash.
+    static Slot makeSlot(size_t offset, size_t keyHash)
+    {
+        return (fingerprint(keyHash) << OFFSET_BITS) | static_cast<Slot>(offset);
+    }
+
+    // Hash function that XORs a key's hash with a salt, mixes the bits and takes modulo capacity.
+    // The mixing step (splitmix64 finalizer) keeps the two indexes independent when capacity is a power of two;
+    // without it both tables would use the same low bits of the hash and colliding keys would collide twice.
+    int hash(size_t keyHash, size_t seed) const
+    {
+        std::uint64_t x = keyHash ^ seed;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return (x ^ (x >> 31)) % capacity;
+    }
+
+    // First hash function using salt1.
+    int hash1(size_t keyHash) const
+    {
+        return hash(keyHash, salt1);
+    }
+
+    // Second hash function using salt2.
+    int hash2(size_t keyHash) const
+    {
+        return hash(keyHash, salt2);
+    }
+
+    // Read the key of the record a slot points to.
+    std::string_view keyAt(Slot slot) const
+    {
+        size_t offset = static_cast<size_t>(slot & OFFSET_MASK);
+        std::uint32_t length;
+        std::memcpy(&length, arena.data() + offset, LENGTH_BYTES);
+        return std::string_view(arena.data() + offset + LENGTH_BYTES, length);
+    }
+
+    // Size of the arena record a slot points to.
+    size_t recordSize(Slot slot) const
+    {
+        return LENGTH_BYTES + keyAt(slot).size();
+    }
+
+    // Append a record for key to arena and return its offset.
+    static size_t append(std::vector<char> &to, std::string_view key)
+    {
+        size_t offset = to.size();
+        std::uint32_t length = static_cast<std::uint32_t>(key.size());
+        to.resize(offset + LENGTH_BYTES + key.size());
+        std::memcpy(to.data() + offset, &length, LENGTH_BYTES);
+        std::memcpy(to.data() + offset + LENGTH_BYTES, key.data(), key.size());
+        return offset;
+    }
+
+    // Check whether the slot holds key (whose hash is keyHash). The arena is only read on a fingerprint match.
+    bool matches(Slot slot, std::string_view key, size_t keyHash) const
+    {
+        return slot != 0 && (slot >> OFFSET_BITS) == fingerprint(keyHash) && keyAt(slot) == key;
+    }
+
+    // Swap the new slot into the specified table position and return the old slot (0 if it was empty).
+    Slot swap(int tableIndex, int idx, Slot slot)
+    {
+        Slot old = table[tableIndex][idx];
+        table[tableIndex][idx] = slot;
+        return old;
+    }
+
+    // Run the displacement loop for a slot whose key hashes to keyHash.
+    // Returns the slot left in hand (0 if everything was placed); every evicted key is rehashed from the arena.
+    Slot displace(Slot slot, size_t keyHash)
+    {
+        for (int i = 0; i < maxDisplacements; ++i)
+        {
+            if ((slot = swap(0, hash1(keyHash), slot)) == 0) // Try placing in table 0.
+                return 0;
+            keyHash = hashKey(keyAt(slot));
+
+            if ((slot = swap(1, hash2(keyHash), slot)) == 0) // Try placing in table 1.
+                return 0;
+            keyHash = hashKey(keyAt(slot));
+        }
+        return slot; // Gave up after maxDisplacements; this key is still homeless.
+    }
+
+    // Copy the live records into a fresh arena and re-place them in tables of newCapacity slots.
+    // pending is a slot that did not fit (0 if none). If the keys do not fit, the tables keep doubling.
+    void rebuild(int newCapacity, Slot pending)
+    {
+        std::vector<std::pair<Slot, size_t>> slots; // Every live key as (slot in the new arena, hash).
+        slots.reserve(count);
+        std::vector<char> compacted;
+        compacted.reserve(arena.size() - garbage);
+        for (const auto &row : table)
+            for (Slot slot : row)
+                if (slot)
+                {
+                    std::string_view key = keyAt(slot);
+                    size_t keyHash = hashKey(key);
+                    slots.emplace_back(makeSlot(append(compacted, key), keyHash), keyHash);
+                }
+        if (pending)
+        {
+            std::string_view key = keyAt(pending);
+            size_t keyHash = hashKey(key);
+            slots.emplace_back(makeSlot(append(compacted, key), keyHash), keyHash);
+        }
+        arena.swap(compacted); // Old offsets are dead from here on; the slots list holds the new ones.
+        garbage = 0;
+
+        capacity = newCapacity;
+        maxDisplacements = capacity / 2 > 0 ? capacity / 2 : 1;
+        bool placed = false;
+        while (!placed)
+        {
+            table = std::vector<std::vector<Slot>>(2, std::vector<Slot>(capacity, 0));
+            salt1 = std::rand(); // New salts give a different pair of hash functions.
+            salt2 = std::rand();
+
+            placed = true;
+            for (const auto &entry : slots)
+            {
+                if (displace(entry.first, entry.second) != 0) // Could not place everything; grow and start over.
+                {
+                    placed = false;
+                    capacity *= 2;
+                    maxDisplacements *= 2;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Copy the live records into a fresh arena, in slot order, and point each slot at its record's new offset.
+    // Fingerprints, salts and positions are unchanged, so nothing is rehashed.
+    void compactArena()
+    {
+        std::vector<char> compacted;
+        compacted.reserve(arena.size() - garbage);
+        for (auto &row : table)
+            for (Slot &slot : row)
+                if (slot)
+                    slot = (slot & ~OFFSET_MASK) | static_cast<Slot>(append(compacted, keyAt(slot)));
+        arena.swap(compacted);
+        garbage = 0;
+    }
+
+    // Check if key (whose hash is keyHash) is present.
+    bool containsKey(std::string_view key, size_t keyHash) const
+    {
+        return matches(table[0][hash1(keyHash)], key, keyHash) || matches(table[1][hash2(keyHash)], key, keyHash);
+    }
+
+public:
+    // Constructor to initialize capacity, maxDisplacements, salts, and table.
+    CuckooStringSet(int initialCapacity = 32)
+        : capacity(initialCapacity),
+          maxDisplacements(initialCapacity / 2 > 0 ? initialCapacity / 2 : 1), // Half the capacity, at least one attempt.
+          count(0),
+          salt1(std::time(nullptr)),                             // Use current time as salt1.
+          salt2(std::time(nullptr) ^ 0x9e3779b9),                // Use XOR of time for salt2.
+          table(2, std::vector<Slot>(initialCapacity, 0)),       // Allocate two empty tables.
+          garbage(0)
+    {
+    }
+
+    // Add a key; its bytes are copied once, to the end of the arena.
+    bool add(std::string_view key)
+    {
+        size_t keyHash = hashKey(key);
+        if (containsKey(key, keyHash))
+            return false; // Avoid duplicates, return false if the key already exists.
+
+        Slot slot = makeSlot(append(arena, key), keyHash);
+        ++count;
+        Slot leftover = displace(slot, keyHash);
+        if (leftover != 0)
+            rebuild(capacity * 2, leftover); // Grow (and compact) with the homeless key carried over.
+        return true;
+    }
+
+    // Remove a key if it exists in the set. Its arena bytes become garbage until the next compaction, which runs
+    // here once garbage is both more than half the arena and at least the size of the tables.
+    bool remove(std::string_view key)
+    {
+        size_t keyHash = hashKey(key);
+        for (int i = 0; i < 2; ++i)
+        {
+            int h = (i == 0) ? hash1(keyHash) : hash2(keyHash);
+            if (matches(table[i][h], key, keyHash))
+            {
+                garbage += recordSize(table[i][h]);
+                table[i][h] = 0; // Mark the slot as empty.
+                --count;
+                if (garbage > arena.size() / 2 && garbage >= 2 * capacity * sizeof(Slot))
+                    compactArena();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Check if the key is present in the set.
+    bool contains(std::string_view key) const
+    {
+        return containsKey(key, hashKey(key));
+    }
+
+    // Count how many keys are stored in the set.
+    int size() const
+    {
+        return count;
+    }
+
+    // Reclaim the arena bytes of removed keys, leaving the tables as they are.
+    void compact()
+    {
+        compactArena();
+    }
+
+    // Bytes held by the tables and the arena (excluding unused vector capacity).
+    size_t memory_usage() const
+    {
+        return 2 * capacity * sizeof(Slot) + arena.size();
+    }
+
+    // Add a list of keys into the set. Returns the number of successful additions.
+    int populate(const std::vector<std::string> &list)
+    {
+        int added = 0;
+        for (const std::string &key : list)
+        {
+            if (add(key))
+                added++;
+        }
+        return added;
+    }
+};
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <vector>     // For std::vector (populate input)
+#include <functional> // For std::hash
+#include <ctime>      // For std::time (used for hashing seeds)
+#include <new>        // For ::operator new / ::operator delete (table arrays)
+#include <utility>    // For std::pair
+#include <optional>   // For std::optional (the result of get)
+#include <cstdint>    // For std::uint64_t (the hash mix)
+#include <atomic>     // For the flag that asks for a grow after a commit
+
+// Entry points of GCC's transactional memory runtime (libitm), which ships no header for them
+extern "C"
+{
+    // Run fn(arg) once the outermost transaction commits (discarded if it aborts)
+    void _ITM_addUserCommitAction(void (*fn)(void *), std::uint64_t resumingTransactionId, void *arg) __attribute__((transaction_pure));
+    // Nonzero inside a transaction
+    int _ITM_inTransaction() __attribute__((transaction_pure));
+}
+
+/*This class implements a Cuckoo Hash Map on top of the transactional engine of CuckooTransactionalSet. get, put, erase and update are declared transaction_safe, so callers can compose several of them inside their own __transaction_atomic block and have them commit (or retry) as one transaction. Each operation still opens its own __transaction_atomic block so it is atomic when called on its own; GCC flattens that block into the caller's transaction when it is nested, so composing operations does not start extra transactions.
+Keys and values are passed by value and get returns the value (as a std::optional) instead of writing it through a reference: GCC can misplace the instrumented accesses to a caller's local whose address is taken inside a transaction, outside of it, which crashes in libitm. K and V must be copyable in a transaction-safe way (trivially copyable types always are).
+put does not grow the tables inside the caller's transaction, where the rebuild would conflict with every concurrent transaction. If the displacement loop fails, the entry left in hand goes to a stash of STASH_SIZE slots that lookups read after missing both tables, and a commit action raises a flag once the transaction commits. The next put, erase or update that runs outside any transaction (on any thread) sees the flag and moves everything into bigger tables in a transaction of its own; libitm does not allow a transaction inside the commit action itself. Only when a composed transaction fills the whole stash do the tables grow inside it. The tables are raw arrays allocated with ::operator new, and new salts are derived from the old ones instead of std::rand, so the rebuild is transaction_safe.
+ */
+
+template <typename K, typename V>
+class CuckooTransactionalMap
+{
+private:
+    // Entry stores the key together with its value; the tables only hold pointers to entries
+    struct Entry
+    {
+        K key;                 // The key used for hashing and comparisons
+        V value;               // The payload associated with the key
+        Entry(const K &initKey, const V &initValue) : key(initKey), value(initValue) {}
+    };
+
+    static constexpr int STASH_SIZE = 4; // Entries a put may leave unplaced before the tables grow inside its transaction
+
+    int capacity;                        // Number of slots per table
+    int maxDisplacements;                // Max number of attempts before resize
+    size_t salt1, salt2;                 // Two seeds for hash functions (to make them different)
+    Entry **table[2];                    // Two hash tables (each a raw array of pointers)
+    Entry *stash[STASH_SIZE] = {};       // Entries the displacement loop could not place, until the tables grow
+    std::atomic<bool> growPending{false}; // Set after a commit that stashed an entry
+
+    // Allocate a table of null pointers (transaction_safe, unlike new[] with a runtime size)
+    static Entry **allocate(int slots) transaction_safe
+    {
+        Entry **row = static_cast<Entry **>(::operator new(sizeof(Entry *) * slots));
+        for (int i = 0; i < slots; ++i)
+            row[i] = nullptr;
+        return row;
+    }
+
+    // Derive a new salt from an old one (splitmix64 step)
+    static size_t nextSalt(size_t salt) transaction_safe
+    {
+        salt += 0x9e3779b97f4a7c15ULL;
+        salt = (salt ^ (salt >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        salt = (salt ^ (salt >> 27)) * 0x94d049bb133111ebULL;
+        return salt ^ (salt >> 31);
+    }
+
+    // Hash function that XORs std::hash with a salt, mixes the result (splitmix64 finalizer, so the two salts give
+    // independent indexes) and takes modulo capacity
+    int hash(K key, size_t seed) const transaction_safe
+    {
+        std::uint64_t x = std::hash<K>{}(key) ^ seed;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return (x ^ (x >> 31)) % capacity;
+    }
+
+    // First hash function using salt1
+    int hash1(K key) const transaction_safe
+    {
+        return hash(key, salt1);
+    }
+
+    // Second hash function using salt2
+    int hash2(K key) const transaction_safe
+    {
+        return hash(key, salt2);
+    }
+
+    // Swap the new entry into the specified table slot, return the old entry (can be null)
+    Entry *swap(int tableIndex, int idx, Entry *entry) transaction_safe
+    {
+        Entry *old = table[tableIndex][idx]; // Store the current occupant
+        table[tableIndex][idx] = entry;      // Replace with new entry
+        return old;                          // Return old occupant (null if empty)
+    }
+
+    // Return the entry holding key, or null (called inside a transaction)
+    Entry *lookup(K key) const transaction_safe
+    {
+        Entry *entry = table[0][hash1(key)];
+        if (entry && entry->key == key)
+            return entry;
+        entry = table[1][hash2(key)];
+        if (entry && entry->key == key)
+            return entry;
+        for (int s = 0; s < STASH_SIZE; ++s)
+            if (stash[s] && stash[s]->key == key)
+                return stash[s];
+        return nullptr;
+    }
+
+    // Run the displacement loop for entry; returns the entry left in hand (null on success)
+    Entry *displace(Entry *entry) transaction_safe
+    {
+        for (int i = 0; i < maxDisplacements && entry != nullptr; ++i)
+        {
+            entry = swap(0, hash1(entry->key), entry);
+            if (entry == nullptr)
+                break;
+            entry = swap(1, hash2(entry->key), entry);
+        }
+        return entry;
+    }
+
+    // Double the tables until every entry, including the stash and pending (if not null), fits (called inside a
+    // transaction)
+    void resize(Entry *pending) transaction_safe
+    {
+        int oldCap = capacity;
+        int count = 0;
+        Entry **entries = allocate(2 * oldCap + STASH_SIZE + 1); // Every entry currently owned by the map
+        for (int i = 0; i < 2; ++i)
+        {
+            for (int j = 0; j < oldCap; ++j)
+                if (table[i][j])
+                    entries[count++] = table[i][j];
+            ::operator delete(table[i]);
+            table[i] = nullptr;
+        }
+        for (int s = 0; s < STASH_SIZE; ++s)
+        {
+            if (stash[s])
+                entries[count++] = stash[s];
+            stash[s] = nullptr;
+        }
+        if (pending)
+            entries[count++] = pending;
+
+        bool placed = false;
+        while (!placed)
+        {
+            if (table[0])
+            {
+                ::operator delete(table[0]);
+                ::operator delete(table[1]);
+            }
+            capacity *= 2;         // Double the capacity
+            maxDisplacements *= 2; // Increase displacement limit
+            table[0] = allocate(capacity);
+            table[1] = allocate(capacity);
+            salt1 = nextSalt(salt1); // New hash functions for the bigger table
+            salt2 = nextSalt(salt2);
+
+            placed = true;
+            for (int k = 0; k < count && placed; ++k)
+                placed = displace(entries[k]) == nullptr;
+        }
+        ::operator delete(entries);
+    }
+
+    // Commit action of a transaction that stashed an entry: ask the next operation outside a transaction to grow
+    static void requestGrow(void *map)
+    {
+        static_cast<CuckooTransactionalMap *>(map)->growPending.store(true, std::memory_order_relaxed);
+    }
+
+    // Store a new entry for a key that is known to be absent (called inside a transaction); an entry the
+    // displacement loop leaves in hand waits in the stash, or makes the tables grow right away if the stash is full
+    void place(Entry *entry) transaction_safe
+    {
+        Entry *leftover = displace(entry);
+        if (leftover == nullptr)
+            return;
+        for (int s = 0; s < STASH_SIZE; ++s)
+        {
+            if (stash[s] == nullptr)
+            {
+                stash[s] = leftover;
+                _ITM_addUserCommitAction(requestGrow, 1, this); // 1: not resuming another transaction
+                return;
+            }
+        }
+        resize(leftover);
+    }
+
+    // True if a committed put stashed an entry and the caller is outside any transaction, so the tables can grow
+    // in a transaction of their own; clears the flag, so one thread grows
+    bool claimGrow() __attribute__((transaction_pure))
+    {
+        return growPending.load(std::memory_order_relaxed) && _ITM_inTransaction() == 0 &&
+               growPending.exchange(false, std::memory_order_relaxed);
+    }
+
+    // Move the stash into bigger tables if a committed put asked for it and no transaction is running. put, erase
+    // and update call it after their own transaction; inside a caller's transaction it does nothing.
+    // Kept out of line so the restart point of its transaction does not sit among the caller's locals
+    __attribute__((noinline)) void growIfRequested() transaction_safe
+    {
+        if (!claimGrow())
+            return;
+        __transaction_atomic
+        {
+            for (int s = 0; s < STASH_SIZE; ++s)
+            {
+                if (stash[s]) // Another grow (or a full stash) may have emptied it already
+                {
+                    resize(nullptr);
+                    break;
+                }
+            }
+        }
+    }
+
+    // The bodies of the public operations. They assume a transaction is already running and never open one.
+    std::optional<V> getImpl(K key) const transaction_safe
+    {
+        std::optional<V> result;
+        if (Entry *entry = lookup(key))
+            result = entry->value;
+        return result;
+    }
+
+    // Kept out of line: inlined into put, the key would live in a register across the start of the transaction,
+    // which a restart may clobber
+    __attribute__((noinline)) bool putImpl(K key, V value) transaction_safe
+    {
+        if (Entry *entry = lookup(key))
+        {
+            entry->value = value;
+            return false;
+        }
+        place(new Entry(key, value));
+        return true;
+    }
+
+    bool eraseImpl(K key) transaction_safe
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            int h = (i == 0) ? hash1(key) : hash2(key);
+            Entry *entry = table[i][h];
+            if (entry && entry->key == key)
+            {
+                table[i][h] = nullptr;
+                delete entry; // Freed when the outermost transaction commits
+                return true;
+            }
+        }
+        for (int s = 0; s < STASH_SIZE; ++s)
+        {
+            Entry *entry = stash[s];
+            if (entry && entry->key == key)
+            {
+                stash[s] = nullptr;
+                delete entry;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename F>
+    bool updateImpl(K key, F &fn) transaction_safe
+    {
+        Entry *entry = lookup(key);
+        if (entry == nullptr)
+            return false;
+        fn(entry->value);
+        return true;
+    }
+
+public:
+    // Constructor to initialize capacity, maxDisplacements, salts, and tables
+    CuckooTransactionalMap(int initialCapacity = 32)
+        : capacity(initialCapacity),
+          maxDisplacements(initialCapacity / 2 > 0 ? initialCapacity / 2 : 1),
+          salt1(std::time(nullptr)),             // Use current time as salt1
+          salt2(std::time(nullptr) ^ 0x9e3779b9) // Use XOR of time for salt2
+    {
+        table[0] = allocate(initialCapacity);
+        table[1] = allocate(initialCapacity);
+    }
+
+    CuckooTransactionalMap(const CuckooTransactionalMap &) = delete;
+    CuckooTransactionalMap &operator=(const CuckooTransactionalMap &) = delete;
+
+    // Destructor to clean up dynamically allocated memory
+    ~CuckooTransactionalMap()
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            for (int j = 0; j < capacity; ++j)
+                delete table[i][j];
+            ::operator delete(table[i]);
+        }
+        for (int s = 0; s < STASH_SIZE; ++s)
+            delete stash[s];
+    }
+
+    // Return a copy of the value for key, or an empty optional if the key is absent.
+    std::optional<V> get(K key) const transaction_safe
+    {
+        std::optional<V> result;
+        __transaction_atomic
+        {
+            result = getImpl(key);
+        }
+        return result;
+    }
+
+    // Insert the pair, or overwrite the value if the key exists. Returns true if a new key was inserted.
+    bool put(K key, V value) transaction_safe
+    {
+        bool inserted = false;
+        __transaction_atomic
+        {
+            inserted = putImpl(key, value);
+        }
+        growIfRequested();
+        return inserted;
+    }
+
+    // Remove the key and its value. Returns false if the key is absent.
+    bool erase(K key) transaction_safe
+    {
+        bool found = false;
+        __transaction_atomic
+        {
+            found = eraseImpl(key);
+        }
+        growIfRequested();
+        return found;
+    }
+
+    // If the key is present, call fn(value) inside the transaction and return true.
+    // fn must be transaction-safe (an inline lambda that only touches memory is).
+    template <typename F>
+    bool update(K key, F fn) transaction_safe
+    {
+        bool found = false;
+        __transaction_atomic
+        {
+            found = updateImpl(key, fn);
+        }
+        growIfRequested();
+        return found;
+    }
+
+    // Check if the key is present using a transaction
+    bool contains(K key) const transaction_safe
+    {
+        bool found = false;
+        __transaction_atomic
+        {
+            found = lookup(key) != nullptr;
+        }
+        return found;
+    }
+
+    // Count how many pairs are stored in total (non-thread-safe)
+    int size() const
+    {
+        int count = 0;
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < capacity; ++j)
+                if (table[i][j])
+                    ++count;
+        for (int s = 0; s < STASH_SIZE; ++s)
+            if (stash[s])
+                ++count;
+        return count;
+    }
+
+    // Insert a list of pairs into the map (non-thread-safe). Returns the number of new keys inserted.
+    int populate(const std::vector<std::pair<K, V>> &list)
+    {
+        int added = 0;
+        for (const auto &kv : list)
+        {
+            if (put(kv.first, kv.second))
+                added++;
+        }
+        return added;
+    }
+};
@@ -3,43 +3,91 @@
 #include <functional> // For std::hash
 #include <ctime>      // For std::time (used for hashing seeds)
 #include <atomic>     // For atomic variables to ensure consistent memory ordering
+#include <utility>    // For std::move, std::forward and std::in_place
+#include <array>      // For std::array (one salt per table)
+#include <cstdint>    // For std::uint64_t
+
+#include "cuckoo-hash.h"   // For stored hashes
+#include "cuckoo-memory.h" // For allocating entries and tables with Allocator
+#include "cuckoo-parallel.h" // For the parallel bulk build
+#include "frozen-cuckoo.h"   // For the immutable set returned by freeze()
+#include "cuckoo-bloom.h"    // For the optional prefilter in front of contains
 
 /*This class implements a Cuckoo Hash Set with transactional support. The key operations like add, remove, and contains are wrapped in atomic transactions to ensure that these operations are atomic and consistent, even in a multi-threaded environment. The set uses two hash tables to store entries, with probing to handle collisions and displacement to move entries in case of conflicts. The set dynamically resizes when it becomes full and ensures thread safety using atomic operations. The class uses C++ transactional memory features to ensure that the add, remove, and contains operations are performed safely across multiple threads.
  */
 
-template <typename T>
+// Hash and KeyEqual default to std::hash<T> and std::equal_to<T>. Keys are hashed outside the transactions, but KeyEqual
+// is called inside them, so it must be transaction-safe: scalar T works, while std::string (whose comparison is not
+// transaction-safe in libstdc++) does not compile. For the same reason this set has no heterogeneous lookup.
+// With StoreHash (the default for non-scalar T), each entry keeps its full hash: keys are hashed outside the transaction,
+// probes compare the stored hash before KeyEqual, and resizing reuses it instead of hashing every key again.
+// Entries and tables are allocated with Allocator (see cuckoo-memory.h). Allocation and deallocation always happen
+// outside the transactions, so the allocator does not need to be transaction-safe.
+// D is the number of tables (2 to 4), as in CuckooSequentialSet: each extra table costs one more probe per lookup
+// inside the transaction, and lets the tables fill much further before a resize.
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>, typename Allocator = std::allocator<T>,
+          bool StoreHash = StoreHashByDefault<T>::value, int D = 2>
 class CuckooTransactionalSet
 {
+    static_assert(D >= 2 && D <= 4, "CuckooTransactionalSet supports 2 to 4 tables");
+
 private:
-    // Entry wraps the actual value; used so we can store pointers and handle nulls
-    struct Entry
+    // Entry wraps the actual value (and its hash, with StoreHash); used so we can store pointers and handle nulls
+    // It is built in place from a const T&, a T&&, or any T constructor arguments
+    using Entry = StoredValue<T, Hash, StoreHash>;
+    using EntryAllocator = RebindAlloc<Allocator, Entry>;
+    using Row = std::vector<Entry *, RebindAlloc<Allocator, Entry *>>; // One hash table (a vector of pointers)
+    using Table = std::vector<Row, RebindAlloc<Allocator, Row>>;
+
+    static constexpr double LOAD_FACTOR = D == 2 ? 0.4 : D == 3 ? 0.8 : 0.9; // Fraction of the slots reserve() plans to fill
+    static constexpr double MAX_LOAD = D == 2 ? 0.5 : D == 3 ? 0.91 : 0.97;    // Load of a full table, for sizing the prefilter
+
+    int capacity;                      // Number of slots per table
+    int maxDisplacements;              // Max number of attempts before resize
+    std::atomic<bool> resizing{false}; // Flag so only one thread resizes at a time
+    std::array<size_t, D> salts;       // One seed per table's hash function (to make them different)
+    EntryAllocator entryAlloc;         // Allocates the entries; rebound copies of it allocate the tables
+    Table table;                       // D hash tables
+    std::atomic<BlockedBloomFilter *> prefilter{nullptr};        // Optional prefilter read by contains (null when disabled)
+    std::vector<std::unique_ptr<BlockedBloomFilter>> prefilters; // Every prefilter built so far; the last one is current
+    int prefilterBitsPerKey = 0;                                 // Bits per key the prefilter is sized with (0 when disabled)
+
+    // D empty tables of the given capacity, allocated with entryAlloc
+    Table makeTable(int slots) const
     {
-        T value;                                 // The actual data stored
-        Entry(T initValue) : value(initValue) {} // Constructor to initialize 'value'
-    };
+        return Table(D, Row(slots, nullptr, entryAlloc), entryAlloc);
+    }
 
-    int capacity;                            // Number of slots per table
-    int maxDisplacements;                    // Max number of attempts before resize
-    std::atomic<bool> resizing{false};       // Flag to prevent recursive resize
-    size_t salt1, salt2;                     // Two seeds for hash functions (to make them different)
-    std::vector<std::vector<Entry *>> table; // Two hash tables (each a vector of pointers)
+    // Salts derived from the current time, one per table
+    static std::array<size_t, D> initialSalts()
+    {
+        std::array<size_t, D> seeds;
+        for (int i = 0; i < D; ++i)
+            seeds[i] = std::time(nullptr) ^ (0x9e3779b9 * i);
+        return seeds;
+    }
 
-    // Hash function that XORs std::hash with a salt and takes modulo capacity
-    int hash(const T &key, size_t seed) const
+    // Hash function that XORs a key's Hash value with a salt, mixes the result (splitmix64 finalizer, so different
+    // salts give independent indexes) and takes modulo capacity
+    // The key is hashed once per operation, outside the transaction
+    int hash(size_t keyHash, size_t seed) const
     {
-        return (std::hash<T>{}(key) ^ seed) % capacity;
+        std::uint64_t x = keyHash ^ seed;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return (x ^ (x >> 31)) % capacity;
     }
 
-    // First hash function using salt1
-    int hash1(const T &key) const
+    // Hash function of table i, using its salt
+    int hashAt(int i, size_t keyHash) const
     {
-        return hash(key, salt1);
+        return hash(keyHash, salts[i]);
     }
 
-    // Second hash function using salt2
-    int hash2(const T &key) const
+    // Check whether the entry holds key (whose Hash value is keyHash); the stored hash is compared first
+    static bool matches(const Entry *entry, const T &key, size_t keyHash)
     {
-        return hash(key, salt2);
+        return entry && entry->hashMatches(keyHash) && KeyEqual{}(entry->value, key);
     }
 
     // Swap the new entry into the specified table slot, return the old entry (can be null)
@@ -50,186 +98,183 @@ private:
         return old;                          // Return old occupant (null if empty)
     }
 
-    // Resize the table (double the size) and re-add all elements
-    void resize()
+    // Run the displacement loop for entry; returns the entry left in hand (null if everything was placed).
+    // The entry in hand takes an empty candidate slot if it has one, otherwise it evicts from the next table after
+    // the one it came from (no std::rand, which is not transaction-safe). Only Entry pointers move between slots,
+    // so the stored values are never copied.
+    __attribute__((noinline)) Entry *displace(Entry *entry)
     {
-        // Use compare_exchange to ensure only one thread performs the resize
-        bool expected = false;
-        if (!resizing.compare_exchange_strong(expected, true))
-            return; // Another thread is already resizing
-
-        int oldCap = capacity; // Store old capacity
-        capacity *= 2;         // Double the capacity
-        maxDisplacements *= 2; // Increase displacement limit
-
-        // Create a temporary vector to hold all current values
-        std::vector<T> allValues;
-        allValues.reserve(oldCap); // Reserve space to avoid reallocations
-
-        // Extract all values from current table
-        for (int i = 0; i < 2; ++i)
+        int from = -1; // Table the entry in hand was evicted from (none for a new entry)
+        for (int i = 0; i < maxDisplacements * D && entry != nullptr; ++i)
         {
-            for (int j = 0; j < oldCap; ++j)
+            size_t keyHash = entry->hash();
+            for (int t = 0; t < D && entry != nullptr; ++t)
             {
-                if (table[i][j])
-                {
-                    allValues.push_back(table[i][j]->value);
-                    delete table[i][j]; // Free old memory
-                    table[i][j] = nullptr;
-                }
+                int h = hashAt(t, keyHash);
+                if (t != from && table[t][h] == nullptr)
+                    entry = swap(t, h, entry);
             }
+            if (entry == nullptr)
+                break;
+
+            from = (from + 1) % D;
+            entry = swap(from, hashAt(from, keyHash), entry);
         }
+        return entry;
+    }
 
-        // Create new empty table of increased size
-        table = std::vector<std::vector<Entry *>>(2, std::vector<Entry *>(capacity, nullptr));
+    // Resize the table (double the size) and move all entries, plus pending, into the new one
+    // seenCapacity is the capacity the displacement of pending failed in
+    void resize(Entry *pending, int seenCapacity)
+    {
+        // Use compare_exchange to ensure only one thread performs the resize
+        bool expected = false;
+        while (!resizing.compare_exchange_weak(expected, true))
+            expected = false; // Another thread is resizing; pending still needs a home, so wait our turn
 
-        // Generate new random salts for hashing
-        salt1 = std::rand();
-        salt2 = std::rand();
+        // If another thread grew the tables while we waited, pending may fit in them now
+        if (capacity != seenCapacity)
+            pending = displaceAtomically(pending).leftover;
+        if (pending != nullptr)
+            rebuild(capacity * 2, pending);
 
-        // Re-add all collected values
-        for (const T &val : allValues)
-        {
-            // Using internal add without transactions to avoid nesting issues
-            bool added = false;
-            Entry *entry = new Entry(val);
-            Entry *temp = entry;
+        resizing.store(false); // Mark resize as complete
+    }
 
-            for (int i = 0; i < maxDisplacements && temp != nullptr; ++i)
-            {
-                int h1 = hash1(temp->value);
-                temp = swap(0, h1, temp);
-                if (temp == nullptr)
-                {
-                    added = true;
-                    break;
-                }
+    // Move all entries (plus pending, if not null) into new tables of newCapacity slots each, doubling again until
+    // everything fits. Runs outside any transaction, so only one thread may call it at a time
+    void rebuild(int newCapacity, Entry *pending)
+    {
+        // Collect all current entries by pointer (values are neither copied nor re-constructed)
+        Row entries(entryAlloc);
+        entries.reserve(D * capacity + 1);
+        for (int i = 0; i < D; ++i)
+            for (int j = 0; j < capacity; ++j)
+                if (table[i][j])
+                    entries.push_back(table[i][j]);
+        if (pending)
+            entries.push_back(pending);
+
+        capacity = newCapacity;
+        maxDisplacements = capacity / 2 > 0 ? capacity / 2 : 1; // Half the capacity, as in the constructor
+        bool placed = false;
+        while (!placed)
+        {
+            // Create new empty table of the target size
+            table = makeTable(capacity);
 
-                int h2 = hash2(temp->value);
-                temp = swap(1, h2, temp);
-                if (temp == nullptr)
-                {
-                    added = true;
-                    break;
-                }
-            }
+            // Generate new random salts for hashing
+            for (size_t &salt : salts)
+                salt = std::rand();
 
-            if (!added)
+            // Re-place all collected entries (internal displacement without transactions to avoid
+            // nesting issues); if one does not fit, grow again and start over
+            placed = true;
+            for (Entry *entry : entries)
             {
-                if (temp != nullptr)
+                if (displace(entry) != nullptr)
                 {
-                    delete temp; // Clean up if we couldn't add
+                    placed = false;
+                    capacity *= 2;         // Double the capacity
+                    maxDisplacements *= 2; // Increase displacement limit
+                    break;
                 }
-                std::cerr << "Warning: Failed to add element during resize.\n";
             }
         }
-
-        resizing.store(false); // Mark resize as complete
+        rebuildPrefilter();
     }
 
-public:
-    // Constructor to initialize capacity, maxDisplacements, salts, and table
-    CuckooTransactionalSet(int initialCapacity = 32)
-        : capacity(initialCapacity),
-          maxDisplacements(initialCapacity / 2),
-          salt1(std::time(nullptr)),              // Use current time as salt1
-          salt2(std::time(nullptr) ^ 0x9e3779b9), // Use XOR of time for salt2
-          table(2, std::vector<Entry *>(initialCapacity, nullptr))
+    // Build a new prefilter (if enabled) from the current entries, sized for a full table, and publish it
+    // Readers may still hold an older prefilter, so older ones are kept until the set is destroyed; each resize
+    // doubles the size, so together they take less memory than the current one
+    void rebuildPrefilter()
     {
-        std::srand(std::time(nullptr)); // Initialize random seed
+        if (prefilterBitsPerKey == 0)
+            return;
+        prefilters.emplace_back(new BlockedBloomFilter(static_cast<size_t>(D * capacity * MAX_LOAD), prefilterBitsPerKey));
+        for (const auto &row : table)
+            for (Entry *entry : row)
+                if (entry)
+                    prefilters.back()->insert(entry->hash());
+        prefilter.store(prefilters.back().get(), std::memory_order_release);
     }
 
-    // Destructor to clean up dynamically allocated memory
-    ~CuckooTransactionalSet()
+    // Slots per table needed to hold n values at LOAD_FACTOR
+    static int capacityFor(size_t n)
     {
-        for (auto &row : table)    // For each row (table 0 and 1)
-            for (auto entry : row) // For each entry in the row
-                delete entry;      // Delete if not null
+        return static_cast<int>(n / (D * LOAD_FACTOR)) + 1;
     }
 
-    // Add a value using Cuckoo hashing inside a transaction
-    bool add(const T &value)
+    // The outcome of one displacement transaction
+    struct Placement
     {
-        // First check if value already exists to avoid transaction overhead
-        bool valueExists = false;
+        Entry *leftover; // The entry left in hand (null if everything was placed)
+        int capacity;    // The capacity the displacement ran in
+    };
 
+    // Run the displacement loop for entry in a transaction of its own. Neither this nor displace is inlined: the
+    // transaction's setjmp-style restart point would otherwise leave the caller's locals open to clobbering
+    __attribute__((noinline)) Placement displaceAtomically(Entry *entry)
+    {
+        Placement result{nullptr, 0};
         __transaction_atomic
         {
-            valueExists = contains(value);
+            result.leftover = displace(entry);
+            result.capacity = capacity;
         }
+        return result;
+    }
 
-        if (valueExists)
-            return false; // Avoid duplicates
+    // Add an entry whose value was built outside any transaction and is not in the set; takes ownership of entry
+    void addEntry(Entry *entry)
+    {
+        size_t keyHash = entry->hash();
 
-        // Create entry outside transaction
-        Entry *entry = new Entry(value);
-        T valueCopy = value; // Make a copy in case we need to retry
-        bool success = false;
-        Entry *leftover = nullptr;
+        // Atomics cannot run inside a transaction, so the prefilter learns the key before the entry is placed,
+        // and again if a resize published a new prefilter meanwhile
+        BlockedBloomFilter *filter = prefilter.load(std::memory_order_acquire);
+        if (filter)
+            filter->insert(keyHash);
 
-        __transaction_atomic
-        {
-            Entry *temp = entry;
+        Placement placement = displaceAtomically(entry); // Any displaced entry is handled outside the transaction
 
-            for (int i = 0; i < maxDisplacements && temp != nullptr; ++i)
-            {
-                int h1 = hash1(temp->value);
-                temp = swap(0, h1, temp);
-                if (temp == nullptr)
-                {
-                    success = true;
-                    break;
-                }
+        BlockedBloomFilter *current = prefilter.load(std::memory_order_acquire);
+        if (current && current != filter)
+            current->insert(keyHash);
 
-                int h2 = hash2(temp->value);
-                temp = swap(1, h2, temp);
-                if (temp == nullptr)
-                {
-                    success = true;
-                    break;
-                }
-            }
-
-            leftover = temp; // Save any displaced entry for cleanup outside transaction
-        }
+        // The entry in hand (not necessarily the new one) could not be placed: grow the table around it
+        if (placement.leftover != nullptr)
+            resize(placement.leftover, placement.capacity);
+    }
 
-        // Handle cleanup and resize outside transaction
-        if (!success)
+    // Add an entry unless its value is already in the set; takes ownership of entry
+    bool addIfAbsent(Entry *entry)
+    {
+        if (containsKey(entry->value, entry->hash()))
         {
-            if (leftover != nullptr)
-                delete leftover;
-            delete entry;
-
-            // Resize and try again
-            resize();
-            return add(valueCopy); // Recursive call with original value
+            deleteObject(entryAlloc, entry); // Avoid duplicates
+            return false;
         }
-
-        return success;
+        addEntry(entry);
+        return true;
     }
 
-    // Remove a value if it exists using a transaction
-    bool remove(const T &value)
+    // Remove the value equal to key if it exists, using a transaction
+    bool removeKey(const T &value)
     {
+        size_t keyHash = Hash{}(value); // Hash outside the transaction
         bool found = false;
         Entry *entryToDelete = nullptr;
 
         __transaction_atomic
         {
-            int h1 = hash1(value);
-            if (table[0][h1] && table[0][h1]->value == value)
+            for (int i = 0; i < D && !found; ++i)
             {
-                entryToDelete = table[0][h1];
-                table[0][h1] = nullptr;
-                found = true;
-            }
-            else
-            {
-                int h2 = hash2(value);
-                if (table[1][h2] && table[1][h2]->value == value)
+                int h = hashAt(i, keyHash);
+                if (matches(table[i][h], value, keyHash))
                 {
-                    entryToDelete = table[1][h2];
-                    table[1][h2] = nullptr;
+                    entryToDelete = table[i][h];
+                    table[i][h] = nullptr;
                     found = true;
                 }
             }
@@ -238,28 +283,32 @@ public:
         // Clean up memory outside transaction
         if (found && entryToDelete)
         {
-            delete entryToDelete;
+            deleteObject(entryAlloc, entryToDelete);
         }
 
         return found;
     }
 
-    // Check if the value is present using a transaction
-    bool contains(const T &value) const
+    // Check if a value equal to key is present, using a transaction
+    bool containsKey(const T &value, size_t keyHash) const
+    {
+        BlockedBloomFilter *filter = prefilter.load(std::memory_order_acquire);
+        if (filter && !filter->mayContain(keyHash)) // Definitely absent: no transaction is started
+            return false;
+        return probeAtomically(value, keyHash);
+    }
+
+    // Probe the D candidate slots of value in a transaction of its own. Kept out of line, like
+    // displaceAtomically, so the transaction's restart point does not sit among the caller's locals
+    __attribute__((noinline)) bool probeAtomically(const T &value, size_t keyHash) const
     {
         bool found = false;
 
         __transaction_atomic
         {
-            int h1 = hash1(value);
-            if (table[0][h1] && table[0][h1]->value == value)
-            {
-                found = true;
-            }
-            else
+            for (int i = 0; i < D && !found; ++i)
             {
-                int h2 = hash2(value);
-                if (table[1][h2] && table[1][h2]->value == value)
+                if (matches(table[i][hashAt(i, keyHash)], value, keyHash))
                 {
                     found = true;
                 }
@@ -269,6 +318,74 @@ public:
         return found;
     }
 
+public:
+    // Constructor to initialize capacity, maxDisplacements, salts, and table
+    CuckooTransactionalSet(int initialCapacity = 32, const Allocator &alloc = Allocator())
+        : capacity(initialCapacity),
+          maxDisplacements(initialCapacity / 2 > 0 ? initialCapacity / 2 : 1),
+          salts(initialSalts()), // Salts from the current time
+          entryAlloc(alloc),
+          table(makeTable(initialCapacity))
+    {
+        std::srand(std::time(nullptr)); // Initialize random seed
+    }
+
+    // Destructor to clean up dynamically allocated memory
+    ~CuckooTransactionalSet()
+    {
+        for (auto &row : table)    // For each row (one per table)
+            for (auto entry : row) // For each entry in the row
+                deleteObject(entryAlloc, entry); // Delete if not null
+    }
+
+    CuckooTransactionalSet(const CuckooTransactionalSet &) = delete;
+    CuckooTransactionalSet &operator=(const CuckooTransactionalSet &) = delete;
+
+    // The allocator the set was constructed with
+    Allocator get_allocator() const
+    {
+        return Allocator(entryAlloc);
+    }
+
+    // Add a value using Cuckoo hashing inside a transaction (the value is copied once into its entry)
+    bool add(const T &value)
+    {
+        size_t keyHash = Hash{}(value);
+        if (containsKey(value, keyHash))
+            return false; // Avoid duplicates without allocating
+        addEntry(newObject(entryAlloc, keyHash, std::in_place, value));
+        return true;
+    }
+
+    // Add a value, moving it into its entry instead of copying it
+    bool add(T &&value)
+    {
+        size_t keyHash = Hash{}(value);
+        if (containsKey(value, keyHash))
+            return false; // Avoid duplicates; value is left untouched
+        addEntry(newObject(entryAlloc, keyHash, std::in_place, std::move(value)));
+        return true;
+    }
+
+    // Construct a value in place from args (outside the transaction) and add it
+    template <typename... Args>
+    bool emplace(Args &&...args)
+    {
+        return addIfAbsent(newObject(entryAlloc, std::in_place, std::forward<Args>(args)...));
+    }
+
+    // Remove a value if it exists using a transaction
+    bool remove(const T &value)
+    {
+        return removeKey(value);
+    }
+
+    // Check if the value is present using a transaction
+    bool contains(const T &value) const
+    {
+        return containsKey(value, Hash{}(value));
+    }
+
     // Count how many entries are stored in total (non-thread-safe)
     int size() const
     {
@@ -280,9 +397,31 @@ public:
         return count;
     }
 
-    // Add a list of values into the table (non-thread-safe)
+    // Total number of slots over the D tables; size() / slot_count() is the current load
+    size_t slot_count() const
+    {
+        return static_cast<size_t>(D) * capacity;
+    }
+
+    // Presize the tables for n values, so adding up to n values in total never triggers a resize (non-thread-safe)
+    void reserve(size_t n)
+    {
+        if (capacityFor(n) > capacity)
+            rebuild(capacityFor(n), nullptr);
+    }
+
+    // Rebuild the tables with newCapacity slots each (or more, if the current values need it) and new hash functions
+    // (non-thread-safe)
+    void rehash(int newCapacity)
+    {
+        int needed = capacityFor(size());
+        rebuild(newCapacity > needed ? newCapacity : needed, nullptr);
+    }
+
+    // Add a list of values into the table (non-thread-safe); the tables are presized for the whole list first
     int populate(const std::vector<T> &list)
     {
+        reserve(size() + list.size());
         int added = 0;
         for (const T &value : list)
         {
@@ -293,4 +432,116 @@ public:
         }
         return added;
     }
+
+    // Add a list of values using the given number of threads (the parallel bulk build described in cuckoo-parallel.h)
+    // Values are first written into empty slots without transactions, one table at a time, so no other operation may
+    // run on the set meanwhile, and the allocator must be thread-safe. The rest go through the transactional add.
+    int populate(const std::vector<T> &list, int threads)
+    {
+        if (threads <= 1)
+            return populate(list);
+        reserve(size() + list.size());
+
+        BulkPartitions parts = partitionKeys(list, threads, capacity, [](const T &value)
+                                             { return Hash{}(value); }, [this](size_t keyHash)
+                                             { return hashAt(0, keyHash); });
+        std::vector<int> added(threads, 0); // Successful additions per thread
+
+        for (int i = 0; i < D; i++) // One transaction-free round per table
+        {
+            BulkPartitions next(threads, std::vector<std::vector<BulkKey>>(threads));
+            runParallel(threads, [&](int p)
+                        {
+                for (int t = 0; t < threads; t++)
+                {
+                    for (const BulkKey &key : parts[t][p])
+                    {
+                        const T &value = list[key.first];
+                        bool present = false;
+                        for (int j = 0; j < D && !present; j++)
+                            present = matches(table[j][hashAt(j, key.second)], value, key.second);
+                        if (present)
+                            continue; // Already present; only partition p writes to this key's slot in this round
+
+                        Entry *&slot = table[i][hashAt(i, key.second)];
+                        if (slot == nullptr)
+                        {
+                            if (BlockedBloomFilter *filter = prefilter.load(std::memory_order_relaxed))
+                                filter->insert(key.second);
+                            slot = newObject(entryAlloc, key.second, std::in_place, value);
+                            added[p]++;
+                        }
+                        else
+                        {
+                            next[p][partitionOf(hashAt((i + 1) % D, key.second), capacity, threads)].push_back(key); // Try the next table
+                        }
+                    }
+                } });
+            parts.swap(next);
+        }
+
+        // Final pass: the values left over are displaced into place by the normal transactional add
+        runParallel(threads, [&](int p)
+                    {
+            for (int t = 0; t < threads; t++)
+                for (const BulkKey &key : parts[t][p])
+                    if (addIfAbsent(newObject(entryAlloc, key.second, std::in_place, list[key.first])))
+                        added[p]++; });
+
+        int total = 0;
+        for (int count : added)
+            total += count;
+        return total;
+    }
+
+    // Put a blocked Bloom filter (see cuckoo-bloom.h) in front of contains, so most misses return without starting
+    // a transaction. It is kept up to date by every add and rebuilt on every resize (non-thread-safe)
+    void enable_prefilter(int bitsPerKey = 10)
+    {
+        prefilterBitsPerKey = bitsPerKey;
+        rebuildPrefilter();
+    }
+
+    // Drop the prefilter; contains runs a transaction again for every key (non-thread-safe)
+    void disable_prefilter()
+    {
+        prefilterBitsPerKey = 0;
+        prefilter.store(nullptr, std::memory_order_release);
+    }
+
+    // Whether contains is prefiltered
+    bool has_prefilter() const
+    {
+        return prefilter.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    // Copy the values into an immutable FrozenCuckooSet, whose lookups need no transactions (non-thread-safe)
+    // The values are copied outside any transaction, so T does not need a transaction-safe copy constructor
+    FrozenCuckooSet<T, Hash, KeyEqual, Allocator> freeze() const
+    {
+        std::vector<T, Allocator> values(get_allocator());
+        std::vector<size_t> hashes;
+        for (const auto &row : table)
+            for (Entry *entry : row)
+                if (entry)
+                {
+                    values.push_back(entry->value);
+                    hashes.push_back(entry->hash());
+                }
+        return FrozenCuckooSet<T, Hash, KeyEqual, Allocator>(std::move(values), hashes, get_allocator());
+    }
+
+    // Add a list of values, moving each one into the table (non-thread-safe)
+    // Values that were already present are left in list; the others are moved-from
+    int populate(std::vector<T> &&list)
+    {
+        reserve(size() + list.size());
+        int added = 0;
+        for (T &value : list)
+        {
+            if (add(std::move(value)))
+                added++;
+        }
+        return added;
+    }
 };
\ No newline at end of file
@@ -6,10 +6,30 @@
 #include <thread>        // For creating threads
 #include <atomic>        // For atomic operations
 #include <iomanip>       // For std::setw (for output formatting)
+#include <limits>        // For std::numeric_limits
+#include <algorithm>     // For std::sort (latency percentiles)
+#include <optional>      // For std::optional (transactional map lookups)
+#include <functional>    // For std::ref
+#include <string>        // For std::string (the keys of the string set)
+#include <memory>        // For std::make_unique (the fixed set is too large for the stack)
 
 #include "header/serial-cuckoo.h"        // Include your sequential cuckoo header
 #include "header/concurrent-cuckoo.h"    // Include your concurrent cuckoo header
 #include "header/transactional-cuckoo.h" // Include your transactional cuckoo header
+#include "header/cuckoo-filter.h"        // Include the cuckoo filter header
+#include "header/concurrent-cuckoo-filter.h" // Include the concurrent cuckoo filter header
+#include "header/horton-cuckoo.h"        // Include the Horton table header
+#include "header/deamortized-cuckoo.h"   // Include the de-amortized cuckoo header
+#include "header/concurrent-hopscotch.h" // Include the concurrent hopscotch header
+#include "header/concurrent-linear-probing.h" // Include the lock-free linear-probing header
+#include "header/robin-hood.h"           // Include the Robin Hood linear-probing header
+#include "header/split-ordered-list.h"   // Include the split-ordered list header
+#include "header/transactional-cuckoo-map.h" // Include the transactional cuckoo map header
+#include "header/concurrent-cuckoo-map.h" // Include the concurrent cuckoo map header
+#include "header/string-cuckoo.h"        // Include the string cuckoo set header
+#include "header/serial-cuckoo-map.h"    // Include the sequential cuckoo map header
+#include "header/frozen-cuckoo.h"        // Include the immutable (frozen) cuckoo set header
+#include "header/fixed-cuckoo.h"         // Include the fixed-capacity cuckoo set header
 
 // GLOBAL VARIABLES that affect performance
 const int numThreads = 4;                                   // Number of threads to be used for concurrent benchmarks
@@ -17,6 +37,8 @@ const int NUM_INITIAL_KEYS = 100000;                        // Number of initial
 const int TOTAL_OPS = 1000000;                              // Total number of operations to perform during benchmarking
 std::uniform_int_distribution<int> value_gen(1, 100000);    // Random generator for values used in operations (contains, add, remove)
 std::uniform_int_distribution<int> val_gen_main(1, 100000); // Random generator for values used in populating the set
+const double FILTER_FPR = 0.003;                            // Target false-positive rate of the cuckoo filter
+const int NUM_COUNTERS = 10000;                             // Keys of the transactional map benchmark
 
 // Struct to track statistics from the benchmark
 struct Stats
@@ -30,8 +52,9 @@ struct Stats
     long long time_ns = 0;                  // Time taken for the benchmark in nanoseconds
 };
 
-// Run benchmark workload on the serial cuckoo set
-void run_serial_benchmark(CuckooSequentialSet<int> &set, int totalOps, Stats &stats)
+// Run benchmark workload on a serial set (the cuckoo set, or a set it is compared with)
+template <typename Set>
+void run_serial_benchmark(Set &set, int totalOps, Stats &stats)
 {
     std::uniform_real_distribution<double> op_dist(0.0, 1.0); // For randomly selecting between contains, add, and remove
     std::mt19937 rng(std::random_device{}());                 // Random number generator
@@ -70,8 +93,9 @@ void run_serial_benchmark(CuckooSequentialSet<int> &set, int totalOps, Stats &st
     stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); // Calculate time taken in nanoseconds
 }
 
-// Run benchmark workload on the concurrent cuckoo set using threads
-void run_concurrent_benchmark(CuckooConcurrentSet<int> &set, int totalOps, Stats &stats)
+// Run benchmark workload on a concurrent set using threads (the cuckoo set, or a set it is compared with)
+template <typename Set>
+void run_concurrent_benchmark(Set &set, int totalOps, Stats &stats)
 {
     std::uniform_real_distribution<double> op_dist(0.0, 1.0); // For randomly selecting between contains, add, and remove
 
@@ -150,6 +174,503 @@ void run_transactional_benchmark(CuckooTransactionalSet<int> &set, int totalOps,
     stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); // Calculate time taken in nanoseconds
 }
 
+// Print the summary of a benchmark run like the sections of the cuckoo sets do, for the sets compared with them
+void print_set_result(const std::string &title, int initiallyAdded, int actualSize, const Stats &stats)
+{
+    int expectedSize = initiallyAdded + stats.successful_adds - stats.successful_removes;
+    double contains_percentage = (stats.hits_contains + stats.misses_contains) > 0
+                                     ? (double)stats.hits_contains / (stats.hits_contains + stats.misses_contains) * 100
+                                     : 0;
+    double add_percentage = (stats.successful_adds + stats.failed_adds) > 0
+                                ? (double)stats.successful_adds / (stats.successful_adds + stats.failed_adds) * 100
+                                : 0;
+    double remove_percentage = (stats.successful_removes + stats.failed_removes) > 0
+                                   ? (double)stats.successful_removes / (stats.successful_removes + stats.failed_removes) * 100
+                                   : 0;
+
+    std::cout << "=== " << title << " ===\n";
+    std::cout << std::setw(30) << std::left << "Initial elements added:" << std::setw(10) << initiallyAdded << "\n";
+    std::cout << std::setw(30) << std::left << "Operations performed:" << std::setw(10) << TOTAL_OPS << "\n";
+    std::cout << std::setw(30) << std::left << "Contains → Hits:" << std::setw(10) << stats.hits_contains
+              << std::setw(10) << "Misses:" << std::setw(10) << stats.misses_contains
+              << std::setw(10) << "Percentage: " << std::fixed << std::setprecision(2) << contains_percentage << "%\n";
+    std::cout << std::setw(30) << std::left << "Add      → Successes:" << std::setw(10) << stats.successful_adds
+              << std::setw(10) << "Failures:" << std::setw(10) << stats.failed_adds
+              << std::setw(10) << "Percentage: " << std::fixed << std::setprecision(2) << add_percentage << "%\n";
+    std::cout << std::setw(30) << std::left << "Remove   → Successes:" << std::setw(10) << stats.successful_removes
+              << std::setw(10) << "Failures:" << std::setw(10) << stats.failed_removes
+              << std::setw(10) << "Percentage: " << std::fixed << std::setprecision(2) << remove_percentage << "%\n";
+    std::cout << std::setw(30) << std::left << "Expected final size:" << std::setw(10) << expectedSize << "\n";
+    std::cout << std::setw(30) << std::left << "Actual final size:" << std::setw(10) << actualSize << "\n";
+    std::cout << std::setw(30) << std::left << "Size correctness:" << (expectedSize == actualSize ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10) << (stats.time_ns / 1000000) << " milliseconds (ms)\n\n"; // milliseconds
+}
+
+// Presents a CuckooStringSet to the int workloads: value v is stored as the decimal string of v. The strings are
+// built once up front, so the workload times the set and not std::to_string
+struct DecimalStringSet
+{
+    CuckooStringSet set;
+    std::vector<std::string> names; // names[v] is the decimal string of v
+
+    DecimalStringSet(int initialCapacity, int maxValue) : set(initialCapacity)
+    {
+        names.reserve(maxValue + 1);
+        for (int v = 0; v <= maxValue; ++v)
+            names.push_back(std::to_string(v));
+    }
+
+    bool add(int value) { return set.add(names[value]); }
+    bool remove(int value) { return set.remove(names[value]); }
+    bool contains(int value) const { return set.contains(names[value]); }
+    int size() const { return set.size(); }
+
+    int populate(const std::vector<int> &keys)
+    {
+        int added = 0;
+        for (int key : keys)
+            if (add(key))
+                added++;
+        return added;
+    }
+};
+
+// Struct to track the lookups on a frozen set
+struct FrozenStats
+{
+    int hits = 0;          // Lookups that found their key
+    int misses = 0;        // Lookups that did not
+    int mismatches = 0;    // Values of val_gen_main's range on which the frozen set and its source disagree (must stay 0)
+    long long time_ns = 0; // Time taken for the lookups in nanoseconds
+};
+
+// Check that the frozen set answers like the set it was frozen from on every value of val_gen_main's range,
+// then time totalOps random lookups on it
+template <typename Set>
+void run_frozen_benchmark(const Set &source, const FrozenCuckooSet<int> &frozen, int totalOps, FrozenStats &stats)
+{
+    std::mt19937 rng(std::random_device{}());
+
+    for (int value = val_gen_main.min(); value <= val_gen_main.max(); ++value)
+        if (frozen.contains(value) != source.contains(value))
+            stats.mismatches++;
+
+    auto start = std::chrono::high_resolution_clock::now(); // Start the timer to measure execution time
+
+    for (int i = 0; i < totalOps; ++i)
+    {
+        if (frozen.contains(val_gen_main(rng)))
+            stats.hits++;
+        else
+            stats.misses++;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();                                      // End the timer
+    stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); // Calculate time taken in nanoseconds
+}
+
+// Presents a CuckooSequentialMap to the int workloads: adding v inserts the pair (v, v), and contains looks the
+// value up with find
+struct MapKeySet
+{
+    CuckooSequentialMap<int, long> map;
+
+    explicit MapKeySet(int initialCapacity) : map(initialCapacity) {}
+
+    bool add(int value) { return map.insert(value, value); }
+    bool remove(int value) { return map.erase(value); }
+    bool contains(int value) const { return map.find(value) != nullptr; }
+    int size() const { return map.size(); }
+
+    int populate(const std::vector<int> &keys)
+    {
+        int added = 0;
+        for (int key : keys)
+            if (add(key))
+                added++;
+        return added;
+    }
+};
+
+// Statistics from the cuckoo filter benchmark
+struct FilterStats
+{
+    int inserted = 0;        // Number of keys the filter accepted
+    int false_negatives = 0; // Inserted keys the filter reported as absent (must stay 0)
+    int false_positives = 0; // Absent keys the filter reported as present
+    long long time_ns = 0;   // Time taken for the lookups in nanoseconds
+};
+
+// Run benchmark workload on the cuckoo filter: insert the keys, check that every one of them is found,
+// then look up totalOps keys that were never inserted (all above the range of val_gen_main)
+void run_filter_benchmark(CuckooFilter<int> &filter, const std::vector<int> &keys, int totalOps, FilterStats &stats)
+{
+    std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> absent_gen(val_gen_main.max() + 1, std::numeric_limits<int>::max()); // Keys never inserted
+
+    for (int key : keys)
+        if (filter.add(key))
+            stats.inserted++;
+
+    auto start = std::chrono::high_resolution_clock::now(); // Start the timer to measure execution time
+
+    for (int key : keys)
+        if (!filter.contains(key))
+            stats.false_negatives++;
+    for (int i = 0; i < totalOps; ++i)
+        if (filter.contains(absent_gen(rng)))
+            stats.false_positives++;
+
+    auto end = std::chrono::high_resolution_clock::now();                                      // End the timer
+    stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); // Calculate time taken in nanoseconds
+}
+
+// Statistics from the concurrent cuckoo filter benchmark
+struct ConcurrentFilterStats
+{
+    std::atomic<long long> lookups{0}; // Lookups done by the reader threads
+    std::atomic<long long> hits{0};    // Lookups that answered "maybe present"
+    int false_negatives = 0;           // Inserted keys missing from the filter at the end (must stay 0)
+    long long time_ns = 0;             // Time taken for the lookups in nanoseconds
+};
+
+// Run a read-mostly workload on the concurrent cuckoo filter: half of the keys are inserted up front, then one
+// loader thread inserts the other half while the reader threads each look up totalOps / readers random keys
+void run_concurrent_filter_benchmark(ConcurrentCuckooFilter<int> &filter, const std::vector<int> &keys, int readers,
+                                     int totalOps, ConcurrentFilterStats &stats)
+{
+    size_t half = keys.size() / 2;
+    for (size_t i = 0; i < half; ++i)
+        filter.add(keys[i]);
+
+    auto start = std::chrono::high_resolution_clock::now(); // Start the timer to measure execution time
+
+    std::thread loader([&filter, &keys, half]
+                       {
+        for (size_t i = half; i < keys.size(); ++i)
+            filter.add(keys[i]); });
+
+    std::vector<std::thread> threads; // Reader threads
+    for (int t = 0; t < readers; ++t)
+    {
+        threads.push_back(std::thread([&filter, &stats, readers, totalOps]
+                                      {
+            std::mt19937 local_rng(std::random_device{}()); // Local RNG for each thread
+            long long hits = 0;
+            for (int i = 0; i < totalOps / readers; ++i)
+                if (filter.contains(value_gen(local_rng)))
+                    hits++;
+            stats.hits += hits;
+            stats.lookups += totalOps / readers; }));
+    }
+
+    for (auto &th : threads)
+        th.join();
+    loader.join();
+
+    auto end = std::chrono::high_resolution_clock::now();                                      // End the timer
+    stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); // Calculate time taken in nanoseconds
+
+    for (int key : keys)
+        if (!filter.contains(key))
+            stats.false_negatives++;
+}
+
+// The sets with D tables (d-ary cuckoo hashing), for the d-ary benchmark
+template <int D>
+using DarySequentialSet = CuckooSequentialSet<int, std::hash<int>, std::equal_to<int>, std::allocator<int>, StoreHashByDefault<int>::value, D>;
+template <int D>
+using DaryTransactionalSet = CuckooTransactionalSet<int, std::hash<int>, std::equal_to<int>, std::allocator<int>, StoreHashByDefault<int>::value, D>;
+
+// Statistics from the d-ary cuckoo benchmark
+struct DaryStats
+{
+    double load_before_resize = 0; // Fraction of the slots in use just before the first resize
+    double lookup_ns = 0;          // Average time of one contains in nanoseconds
+    bool all_found = true;         // Every key added was found afterwards
+    long long time_ns = 0;         // Time taken for the lookups in nanoseconds
+};
+
+// Add keys one by one to a set with about one slot per key until it first resizes, to measure the load its tables
+// reach; then add the remaining keys and time totalOps lookups, alternating keys of the set and absent keys
+template <typename Set>
+void run_dary_benchmark(Set &set, const std::vector<int> &keys, int totalOps, DaryStats &stats)
+{
+    size_t slots = set.slot_count();
+    size_t added = 0;
+    for (int key : keys)
+    {
+        if (set.add(key))
+            added++;
+        if (stats.load_before_resize == 0 && set.slot_count() != slots)
+            stats.load_before_resize = (double)(added - 1) / slots; // The key that did not fit is not counted
+    }
+
+    std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> absent_gen(val_gen_main.min(), val_gen_main.max()); // Keys never added (keys are above this range)
+    std::vector<int> queries(totalOps);
+    for (int i = 0; i < totalOps; ++i)
+        queries[i] = i % 2 == 0 ? keys[(i / 2) % keys.size()] : absent_gen(rng);
+
+    auto start = std::chrono::high_resolution_clock::now(); // Start the timer to measure execution time
+
+    long long hits = 0;
+    for (int key : queries)
+        if (set.contains(key))
+            hits++;
+
+    auto end = std::chrono::high_resolution_clock::now();                                      // End the timer
+    stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); // Calculate time taken in nanoseconds
+    stats.lookup_ns = (double)stats.time_ns / totalOps;
+
+    for (int key : keys)
+        stats.all_found = stats.all_found && set.contains(key);
+    stats.all_found = stats.all_found && hits >= (totalOps + 1) / 2;
+}
+
+// Print one line of the d-ary benchmark
+void print_dary_result(const std::string &label, const DaryStats &stats)
+{
+    std::cout << std::setw(30) << std::left << label << std::setw(10) << "Load:" << std::fixed << std::setprecision(2)
+              << std::setw(10) << stats.load_before_resize * 100 << std::setw(10) << "Lookup:" << stats.lookup_ns << " ns\n";
+}
+
+// Statistics from the Horton table benchmark
+struct HortonStats
+{
+    double hit_buckets = 0;  // Average buckets read by a lookup of a key in the set
+    double miss_buckets = 0; // Average buckets read by a lookup of an absent key
+    bool all_found = true;   // Every key added was found afterwards
+    long long time_ns = 0;   // Time taken for the lookups in nanoseconds
+};
+
+// Add the keys to the Horton table, count the buckets lookups read, and time totalOps lookups alternating keys of
+// the set and absent keys (val_gen_main's range, which the keys are above)
+void run_horton_benchmark(HortonCuckooSet<int> &set, const std::vector<int> &keys, int totalOps, HortonStats &stats)
+{
+    for (int key : keys)
+        set.add(key);
+
+    std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> absent_gen(val_gen_main.min(), val_gen_main.max());
+    std::vector<int> queries(totalOps);
+    long long hit_buckets = 0, miss_buckets = 0;
+    for (int i = 0; i < totalOps; ++i)
+    {
+        queries[i] = i % 2 == 0 ? keys[(i / 2) % keys.size()] : absent_gen(rng);
+        (i % 2 == 0 ? hit_buckets : miss_buckets) += set.buckets_probed(queries[i]);
+    }
+    stats.hit_buckets = (double)hit_buckets / ((totalOps + 1) / 2);
+    stats.miss_buckets = (double)miss_buckets / (totalOps / 2);
+
+    auto start = std::chrono::high_resolution_clock::now(); // Start the timer to measure execution time
+
+    long long hits = 0;
+    for (int key : queries)
+        if (set.contains(key))
+            hits++;
+
+    auto end = std::chrono::high_resolution_clock::now();                                      // End the timer
+    stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); // Calculate time taken in nanoseconds
+
+    for (int key : keys)
+        stats.all_found = stats.all_found && set.contains(key);
+    stats.all_found = stats.all_found && hits == (totalOps + 1) / 2;
+}
+
+// Struct to track the latency of single adds, for the de-amortized benchmark
+struct AddLatencyStats
+{
+    long long median_ns = 0;   // Median time of one add in nanoseconds
+    long long p999_ns = 0;     // 99.9th percentile
+    long long max_ns = 0;      // Slowest add
+    size_t max_queue = 0;      // Longest queue of pending values seen (de-amortized set only)
+    bool all_found = true;     // Every key added was found afterwards
+    long long time_ns = 0;     // Time taken for all the adds in nanoseconds
+};
+
+// Queue length of the de-amortized set; other sets have no queue
+template <typename Set>
+size_t pending_values(const Set &) { return 0; }
+
+template <typename T>
+size_t pending_values(const DeamortizedCuckooSet<T> &set) { return set.queue_length(); }
+
+// Add the keys one at a time to a set that starts small, so it grows many times, and time every add
+template <typename Set>
+void run_add_latency_benchmark(Set &set, const std::vector<int> &keys, AddLatencyStats &stats)
+{
+    std::vector<long long> latencies;
+    latencies.reserve(keys.size());
+    for (int key : keys)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        set.add(key);
+        auto end = std::chrono::high_resolution_clock::now();
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        stats.max_queue = std::max(stats.max_queue, pending_values(set));
+    }
+
+    for (long long ns : latencies)
+        stats.time_ns += ns;
+    std::sort(latencies.begin(), latencies.end());
+    stats.median_ns = latencies[latencies.size() / 2];
+    stats.p999_ns = latencies[latencies.size() * 999 / 1000];
+    stats.max_ns = latencies.back();
+
+    for (int key : keys)
+        stats.all_found = stats.all_found && set.contains(key);
+    stats.all_found = stats.all_found && set.size() == (int)keys.size();
+}
+
+// Print one line of the de-amortized benchmark
+void print_add_latency_result(const std::string &label, const AddLatencyStats &stats)
+{
+    std::cout << std::setw(30) << std::left << label << "Median: " << std::setw(8) << stats.median_ns
+              << "p99.9: " << std::setw(10) << stats.p999_ns << "Max: " << stats.max_ns << " ns\n";
+}
+
+// Struct to track one run of the growth benchmark
+struct GrowthStats
+{
+    long long time_ns = 0; // Time taken for all the adds in nanoseconds
+    bool all_found = true; // Every key added was found afterwards
+};
+
+// Add the keys with numThreads threads to a set that starts small, so it has to grow many times while they add
+template <typename Set>
+void run_growth_benchmark(Set &set, const std::vector<int> &keys, GrowthStats &stats)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            size_t begin = keys.size() * t / numThreads;
+            size_t end = keys.size() * (t + 1) / numThreads;
+            for (size_t i = begin; i < end; ++i)
+                set.add(keys[i]); });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    for (int key : keys)
+        stats.all_found = stats.all_found && set.contains(key);
+    stats.all_found = stats.all_found && set.size() == (int)keys.size();
+}
+
+// Print one line of the growth benchmark
+void print_growth_result(const std::string &label, const GrowthStats &stats)
+{
+    std::cout << std::setw(30) << std::left << label << std::setw(10) << (stats.time_ns / 1000000) << " milliseconds (ms)\n";
+}
+
+// Struct to track the counter benchmark of the concurrent map
+struct MapStats
+{
+    long long time_ns = 0;  // Time taken for all the increments in nanoseconds
+    bool consistent = true; // The counters add up to the number of increments
+};
+
+// Key of counter c; multiples of 2^16, which the two tables would place in the same few probe sets without mixing
+static int counter_key(int c)
+{
+    return c << 16;
+}
+
+// One thread's share of the increments: every other one goes through compute_if_present, falling back to upsert
+// when the counter does not exist yet, and the rest through upsert alone
+static void run_map_counter_thread(CuckooConcurrentMap<int, long> &map, int thread, int increments, int counters)
+{
+    auto increment = [](long &count) { ++count; };
+    for (int i = 0; i < increments; ++i)
+    {
+        int key = counter_key((i * numThreads + thread) % counters);
+        if (i % 2 == 0 || !map.compute_if_present(key, increment))
+            map.upsert(key, increment, 1L);
+    }
+}
+
+// Increment counters from numThreads threads, then read them back with find and check no increment was lost
+void run_map_benchmark(CuckooConcurrentMap<int, long> &map, int counters, int totalOps, MapStats &stats)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+        threads.emplace_back(run_map_counter_thread, std::ref(map), t, totalOps / numThreads, counters);
+    for (auto &thread : threads)
+        thread.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    long total = 0;
+    for (int c = 0; c < counters; ++c)
+        stats.consistent = map.find(counter_key(c), [&](const long &count) { total += count; }) && stats.consistent;
+    bool absent = !map.find(counter_key(counters), [](const long &) {}) && !map.compute_if_present(counter_key(counters), [](long &) {});
+    stats.consistent = stats.consistent && absent && total == totalOps / numThreads * numThreads && map.size() == counters;
+}
+
+// Struct to track the composed-transaction benchmark of the transactional map
+struct ComposedStats
+{
+    long long time_ns = 0; // Time taken for all the increments in nanoseconds
+    bool consistent = true; // The counters add up to the number of increments
+};
+
+// Increment the counter of key in one composed transaction: a get and a put that commit together
+// The transactions in this benchmark stay out of line, so the restart point of one never sits in a caller's loop,
+// whose locals it could clobber
+__attribute__((noinline)) static void increment_counter(CuckooTransactionalMap<int, long> &map, int key)
+{
+    __transaction_atomic
+    {
+        if (std::optional<long> count = map.get(key))
+            map.put(key, *count + 1);
+        else
+            map.put(key, 1);
+    }
+}
+
+// Read the counter of key (0 if it was never incremented)
+__attribute__((noinline)) static long read_counter(const CuckooTransactionalMap<int, long> &map, int key)
+{
+    return map.get(key).value_or(0);
+}
+
+// One thread's share of the increments
+static void run_counter_thread(CuckooTransactionalMap<int, long> &map, int thread, int increments, int counters)
+{
+    for (int i = 0; i < increments; ++i)
+        increment_counter(map, (i * numThreads + thread) % counters);
+}
+
+// Create every other counter with plain puts (the tables grow between them), then increment all the counters from
+// numThreads threads with composed transactions (which insert the missing ones), then check no increment was lost
+void run_composed_benchmark(CuckooTransactionalMap<int, long> &map, int counters, int totalOps, ComposedStats &stats)
+{
+    std::vector<std::pair<int, long>> initial;
+    for (int key = 0; key < counters; key += 2)
+        initial.emplace_back(key, 0);
+    map.populate(initial);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+        threads.emplace_back(run_counter_thread, std::ref(map), t, totalOps / numThreads, counters);
+    for (auto &thread : threads)
+        thread.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    long total = 0;
+    for (int key = 0; key < counters; ++key)
+        total += read_counter(map, key);
+    stats.consistent = total == totalOps / numThreads * numThreads && map.size() == counters;
+}
+
 int main()
 {
     std::vector<int> initialKeys;
@@ -209,7 +730,7 @@ int main()
 
     // Initialize and populate the concurrent set
     CuckooConcurrentSet<int> cuckooConcurrentSet(2 * NUM_INITIAL_KEYS);
-    int initially_added_concurrent = cuckooConcurrentSet.populate(initialKeys); // Track the number of elements added
+    int initially_added_concurrent = cuckooConcurrentSet.populate(initialKeys, numThreads); // Parallel bulk build; track the number of elements added
 
     // Run benchmark for the concurrent version
     Stats stats_concurrent;
@@ -250,7 +771,7 @@ int main()
 
     // Initialize and populate the transactional set
     CuckooTransactionalSet<int> cuckooTransactionalSet(2 * NUM_INITIAL_KEYS);
-    int initially_added_transactional = cuckooTransactionalSet.populate(initialKeys); // Track the number of elements added
+    int initially_added_transactional = cuckooTransactionalSet.populate(initialKeys, numThreads); // Parallel bulk build; track the number of elements added
 
     // Run benchmark for the transactional version
     Stats stats_transactional;
@@ -289,5 +810,228 @@ int main()
     std::cout << std::setw(30) << std::left << "Size correctness:" << (expectedSize_transactional == actualSize_transactional ? "PASS ✅" : "FAIL ❌") << "\n";
     std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10) << (stats_transactional.time_ns / 1000000) << " milliseconds (ms)\n\n"; // milliseconds
 
+    // Build the cuckoo filter from the same keys and measure its error rates
+    CuckooFilter<int> cuckooFilter(NUM_INITIAL_KEYS, FILTER_FPR);
+    FilterStats stats_filter;
+    run_filter_benchmark(cuckooFilter, initialKeys, TOTAL_OPS, stats_filter);
+
+    // Output filter benchmark summary
+    std::cout << "=== Cuckoo Filter Benchmark ===\n";
+    std::cout << std::setw(30) << std::left << "Keys inserted:" << std::setw(10) << stats_filter.inserted << "\n";
+    std::cout << std::setw(30) << std::left << "Absent keys queried:" << std::setw(10) << TOTAL_OPS << "\n";
+    std::cout << std::setw(30) << std::left << "Fingerprint bits:" << std::setw(10) << cuckooFilter.fingerprint_bits()
+              << std::setw(10) << "Load:" << std::fixed << std::setprecision(2) << cuckooFilter.load_factor() * 100 << "%\n";
+    std::cout << std::setw(30) << std::left << "Bits per key:" << std::fixed << std::setprecision(2)
+              << 8.0 * cuckooFilter.memory_usage() / stats_filter.inserted << "\n";
+    std::cout << std::setw(30) << std::left << "False positive rate:" << std::fixed << std::setprecision(4)
+              << (double)stats_filter.false_positives / TOTAL_OPS * 100 << "%" << std::setw(10) << "  Target: " << FILTER_FPR * 100 << "%\n";
+    std::cout << std::setw(30) << std::left << "No false negatives:" << (stats_filter.false_negatives == 0 ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10) << (stats_filter.time_ns / 1000000) << " milliseconds (ms)\n\n"; // milliseconds
+
+    // Run the concurrent filter benchmark with one reader thread and with numThreads readers, to show how lookups scale
+    std::cout << "=== Concurrent Cuckoo Filter Benchmark ===\n";
+    bool no_false_negatives = true;
+    long long concurrent_filter_ns = 0;
+    for (int readers : {1, numThreads})
+    {
+        ConcurrentCuckooFilter<int> concurrentFilter(NUM_INITIAL_KEYS, FILTER_FPR);
+        ConcurrentFilterStats stats_concurrent_filter;
+        run_concurrent_filter_benchmark(concurrentFilter, initialKeys, readers, TOTAL_OPS, stats_concurrent_filter);
+        no_false_negatives = no_false_negatives && stats_concurrent_filter.false_negatives == 0;
+        concurrent_filter_ns += stats_concurrent_filter.time_ns;
+
+        double mops = stats_concurrent_filter.time_ns > 0 ? stats_concurrent_filter.lookups * 1000.0 / stats_concurrent_filter.time_ns : 0;
+        std::cout << std::setw(30) << std::left << ("Readers: " + std::to_string(readers)) << std::setw(10) << std::fixed << std::setprecision(2) << mops
+                  << std::setw(10) << "Mops/s" << std::setw(10) << "Hits:" << stats_concurrent_filter.hits << "\n";
+    }
+    std::cout << std::setw(30) << std::left << "No false negatives:" << (no_false_negatives ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10) << (concurrent_filter_ns / 1000000) << " milliseconds (ms)\n\n"; // milliseconds
+
+    // Compare two, three and four tables on the sequential and transactional sets: how full the tables get before
+    // the first resize, and what the extra probes cost per lookup
+    // The keys are random 31-bit values: initialKeys cover a dense range, which any modulo hash places without collisions
+    std::cout << "=== d-ary Cuckoo Benchmark ===\n";
+    std::vector<int> daryKeys;
+    std::unordered_set<int> daryCheck;
+    std::uniform_int_distribution<int> dary_gen(0, std::numeric_limits<int>::max());
+    while (daryKeys.size() < NUM_INITIAL_KEYS)
+    {
+        int key = dary_gen(rng);
+        if (key > val_gen_main.max() && daryCheck.insert(key).second) // Leave val_gen_main's range for the absent keys
+            daryKeys.push_back(key);
+    }
+    bool dary_found = true;
+    long long dary_ns = 0;
+    auto report_dary = [&](const std::string &label, const DaryStats &stats)
+    {
+        print_dary_result(label, stats);
+        dary_found = dary_found && stats.all_found;
+        dary_ns += stats.time_ns;
+    };
+    {
+        DarySequentialSet<2> set2(NUM_INITIAL_KEYS / 2);
+        DarySequentialSet<3> set3(NUM_INITIAL_KEYS / 3);
+        DarySequentialSet<4> set4(NUM_INITIAL_KEYS / 4);
+        DaryStats stats2, stats3, stats4;
+        run_dary_benchmark(set2, daryKeys, TOTAL_OPS, stats2);
+        run_dary_benchmark(set3, daryKeys, TOTAL_OPS, stats3);
+        run_dary_benchmark(set4, daryKeys, TOTAL_OPS, stats4);
+        report_dary("Sequential, 2 tables:", stats2);
+        report_dary("Sequential, 3 tables:", stats3);
+        report_dary("Sequential, 4 tables:", stats4);
+    }
+    {
+        DaryTransactionalSet<2> set2(NUM_INITIAL_KEYS / 2);
+        DaryTransactionalSet<3> set3(NUM_INITIAL_KEYS / 3);
+        DaryTransactionalSet<4> set4(NUM_INITIAL_KEYS / 4);
+        DaryStats stats2, stats3, stats4;
+        run_dary_benchmark(set2, daryKeys, TOTAL_OPS, stats2);
+        run_dary_benchmark(set3, daryKeys, TOTAL_OPS, stats3);
+        run_dary_benchmark(set4, daryKeys, TOTAL_OPS, stats4);
+        report_dary("Transactional, 2 tables:", stats2);
+        report_dary("Transactional, 3 tables:", stats3);
+        report_dary("Transactional, 4 tables:", stats4);
+    }
+    std::cout << std::setw(30) << std::left << "All keys found:" << (dary_found ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10) << (dary_ns / 1000000) << " milliseconds (ms)\n\n"; // milliseconds
+
+    // Fill a Horton table sized for about 92% load with the same keys, and count how many buckets lookups read
+    HortonCuckooSet<int> hortonSet(static_cast<int>(NUM_INITIAL_KEYS / 0.92));
+    HortonStats stats_horton;
+    run_horton_benchmark(hortonSet, daryKeys, TOTAL_OPS, stats_horton);
+
+    std::cout << "=== Horton Table Benchmark ===\n";
+    std::cout << std::setw(30) << std::left << "Keys inserted:" << std::setw(10) << hortonSet.size()
+              << std::setw(10) << "Load:" << std::fixed << std::setprecision(2) << hortonSet.load_factor() * 100 << "%\n";
+    std::cout << std::setw(30) << std::left << "Buckets per lookup → Hits:" << std::setw(10) << std::setprecision(3) << stats_horton.hit_buckets
+              << std::setw(10) << "Misses:" << stats_horton.miss_buckets << "\n";
+    std::cout << std::setw(30) << std::left << "Lookup:" << std::setprecision(2) << (double)stats_horton.time_ns / TOTAL_OPS << " ns\n";
+    std::cout << std::setw(30) << std::left << "All keys found:" << (stats_horton.all_found ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10) << (stats_horton.time_ns / 1000000) << " milliseconds (ms)\n\n"; // milliseconds
+
+    // Time every add of the same keys into sets that start with 16 slots per table: the sequential set pays for
+    // its displacement loops and resizes all at once, the de-amortized set a fixed number of steps per add
+    CuckooSequentialSet<int> latencySequential(16);
+    DeamortizedCuckooSet<int> latencyDeamortized(16);
+    AddLatencyStats stats_latency_seq, stats_latency_deam;
+    run_add_latency_benchmark(latencySequential, daryKeys, stats_latency_seq);
+    run_add_latency_benchmark(latencyDeamortized, daryKeys, stats_latency_deam);
+
+    std::cout << "=== De-amortized Cuckoo Benchmark ===\n";
+    print_add_latency_result("Sequential add:", stats_latency_seq);
+    print_add_latency_result("De-amortized add:", stats_latency_deam);
+    std::cout << std::setw(30) << std::left << "Longest pending queue:" << stats_latency_deam.max_queue << "\n";
+    std::cout << std::setw(30) << std::left << "All keys found:"
+              << (stats_latency_seq.all_found && stats_latency_deam.all_found ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10)
+              << ((stats_latency_seq.time_ns + stats_latency_deam.time_ns) / 1000000) << " milliseconds (ms)\n\n"; // milliseconds
+
+    // Run the concurrent workload on a hopscotch set, to compare it with the concurrent cuckoo set
+    HopscotchConcurrentSet<int> hopscotchSet(2 * NUM_INITIAL_KEYS);
+    int initially_added_hopscotch = hopscotchSet.populate(initialKeys, numThreads);
+    Stats stats_hopscotch;
+    run_concurrent_benchmark(hopscotchSet, TOTAL_OPS, stats_hopscotch);
+    print_set_result("Concurrent Hopscotch Set Benchmark", initially_added_hopscotch, hopscotchSet.size(), stats_hopscotch);
+
+    // Run the concurrent workload on a lock-free linear-probing set, the simplest lock-free design to compare with
+    LockFreeLinearSet<int> linearSet(2 * NUM_INITIAL_KEYS);
+    int initially_added_linear = linearSet.populate(initialKeys, numThreads);
+    Stats stats_linear;
+    run_concurrent_benchmark(linearSet, TOTAL_OPS, stats_linear);
+    print_set_result("Lock-free Linear Probing Set Benchmark", initially_added_linear, linearSet.size(), stats_linear);
+
+    // Run the serial workload on a Robin Hood linear-probing set, to compare it with the sequential cuckoo set
+    RobinHoodSet<int> robinHoodSet(2 * NUM_INITIAL_KEYS);
+    int initially_added_robin_hood = robinHoodSet.populate(initialKeys);
+    Stats stats_robin_hood;
+    run_serial_benchmark(robinHoodSet, TOTAL_OPS, stats_robin_hood);
+    print_set_result("Robin Hood Set Benchmark", initially_added_robin_hood, robinHoodSet.size(), stats_robin_hood);
+
+    // Run the serial workload on the sequential map, each value stored as a key mapped to itself
+    MapKeySet sequentialMap(2 * NUM_INITIAL_KEYS);
+    int initially_added_map = sequentialMap.populate(initialKeys);
+    Stats stats_sequential_map;
+    run_serial_benchmark(sequentialMap, TOTAL_OPS, stats_sequential_map);
+    print_set_result("Cuckoo Sequential Map Benchmark", initially_added_map, sequentialMap.size(), stats_sequential_map);
+
+    // Run the serial workload on the string set, every value stored as its decimal string in the key arena
+    DecimalStringSet stringSet(2 * NUM_INITIAL_KEYS, val_gen_main.max());
+    int initially_added_string = stringSet.populate(initialKeys);
+    Stats stats_string;
+    run_serial_benchmark(stringSet, TOTAL_OPS, stats_string);
+    print_set_result("Cuckoo String Set Benchmark", initially_added_string, stringSet.size(), stats_string);
+
+    // Run the serial workload on the fixed-capacity set; its tables are stored inline, so it is allocated once here
+    auto fixedSet = std::make_unique<FixedCuckooSet<int, 2 * NUM_INITIAL_KEYS>>();
+    int initially_added_fixed = fixedSet->populate(initialKeys);
+    Stats stats_fixed;
+    run_serial_benchmark(*fixedSet, TOTAL_OPS, stats_fixed);
+    print_set_result("Fixed Cuckoo Set Benchmark", initially_added_fixed, fixedSet->size(), stats_fixed);
+
+    // Freeze the sequential set as the serial workload left it, and time lookups on the immutable copy
+    FrozenCuckooSet<int> frozenSet = cuckooSet.freeze();
+    FrozenStats stats_frozen;
+    run_frozen_benchmark(cuckooSet, frozenSet, TOTAL_OPS, stats_frozen);
+
+    std::cout << "=== Frozen Cuckoo Set Benchmark ===\n";
+    std::cout << std::setw(30) << std::left << "Frozen keys:" << std::setw(10) << frozenSet.size()
+              << std::setw(10) << "Source:" << cuckooSet.size() << "\n";
+    std::cout << std::setw(30) << std::left << "Contains → Hits:" << std::setw(10) << stats_frozen.hits
+              << std::setw(10) << "Misses:" << stats_frozen.misses << "\n";
+    std::cout << std::setw(30) << std::left << "Memory:" << std::setw(10) << frozenSet.memory_usage() << " bytes\n";
+    std::cout << std::setw(30) << std::left << "Lookup correctness:"
+              << (stats_frozen.mismatches == 0 && frozenSet.size() == cuckooSet.size() ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10) << (stats_frozen.time_ns / 1000000)
+              << " milliseconds (ms)\n\n"; // milliseconds
+
+    // Add the same keys from numThreads threads to concurrent sets that start with 16 buckets: the cuckoo set grows
+    // by global resizes, the split-ordered list one bucket at a time without moving any value
+    CuckooConcurrentSet<int> growthCuckoo(16);
+    HopscotchConcurrentSet<int> growthHopscotch(16);
+    LockFreeLinearSet<int> growthLinear(16);
+    SplitOrderedSet<int> growthSplitOrdered(16);
+    GrowthStats stats_growth_cuckoo, stats_growth_hopscotch, stats_growth_linear, stats_growth_split;
+    run_growth_benchmark(growthCuckoo, daryKeys, stats_growth_cuckoo);
+    run_growth_benchmark(growthHopscotch, daryKeys, stats_growth_hopscotch);
+    run_growth_benchmark(growthLinear, daryKeys, stats_growth_linear);
+    run_growth_benchmark(growthSplitOrdered, daryKeys, stats_growth_split);
+
+    std::cout << "=== Growth Benchmark ===\n";
+    print_growth_result("Concurrent cuckoo:", stats_growth_cuckoo);
+    print_growth_result("Concurrent hopscotch:", stats_growth_hopscotch);
+    print_growth_result("Lock-free linear probing:", stats_growth_linear);
+    print_growth_result("Split-ordered list:", stats_growth_split);
+    bool growth_found = stats_growth_cuckoo.all_found && stats_growth_hopscotch.all_found &&
+                        stats_growth_linear.all_found && stats_growth_split.all_found;
+    std::cout << std::setw(30) << std::left << "All keys found:" << (growth_found ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10)
+              << ((stats_growth_cuckoo.time_ns + stats_growth_hopscotch.time_ns + stats_growth_linear.time_ns +
+                   stats_growth_split.time_ns) / 1000000)
+              << " milliseconds (ms)\n\n"; // milliseconds
+
+    // Increment counters in a concurrent map that starts small, each increment an upsert or a compute_if_present
+    // callback run under the key's lock stripes
+    CuckooConcurrentMap<int, long> concurrentCounterMap(32);
+    MapStats stats_map;
+    run_map_benchmark(concurrentCounterMap, NUM_COUNTERS, TOTAL_OPS, stats_map);
+
+    std::cout << "=== Concurrent Map Benchmark ===\n";
+    std::cout << std::setw(30) << std::left << "Counters:" << std::setw(10) << concurrentCounterMap.size()
+              << std::setw(10) << "Increments:" << TOTAL_OPS << "\n";
+    std::cout << std::setw(30) << std::left << "Upsert correctness:" << (stats_map.consistent ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10) << (stats_map.time_ns / 1000000) << " milliseconds (ms)\n\n"; // milliseconds
+
+    // Increment counters in a transactional map that starts small, each increment a get and a put composed into
+    // one transaction
+    CuckooTransactionalMap<int, long> counterMap(32);
+    ComposedStats stats_composed;
+    run_composed_benchmark(counterMap, NUM_COUNTERS, TOTAL_OPS / 10, stats_composed);
+
+    std::cout << "=== Transactional Map Benchmark ===\n";
+    std::cout << std::setw(30) << std::left << "Counters:" << std::setw(10) << counterMap.size()
+              << std::setw(10) << "Increments:" << TOTAL_OPS / 10 << "\n";
+    std::cout << std::setw(30) << std::left << "Composed correctness:" << (stats_composed.consistent ? "PASS ✅" : "FAIL ❌") << "\n";
+    std::cout << std::setw(30) << std::left << "Time taken:" << std::setw(10) << (stats_composed.time_ns / 1000000) << " milliseconds (ms)\n\n"; // milliseconds
+
     return 0;
 }